@@ -1,46 +1,29 @@
 #include "WM.hpp"
+#include "executor/executor.hpp"
+#include "simd/dispatch.hpp"
 
-void WM::POB() {
+static_assert(sizeof(WMPixel) == 2, "ядра POB ожидают пары байт (highBits, lowBits)");
 
+void WM::POB() {
     auto processLayer = [&](std::vector<WMPixel>& layer, std::vector<unsigned char>& key) {
-        for (size_t i = 0; i < size; ++i) {
-            unsigned char lowBits = layer[i].lowBits;
-            key[i] = R_LUT[lowBits];
-            layer[i].lowBits = LOW_BITS_LUT[lowBits];
-        }
+        simd::kernels().pob(reinterpret_cast<unsigned char*>(layer.data()), key.data(), size);
     };
 
-    std::thread threadRLay(processLayer, std::ref(RLay), std::ref(r_b_key));
-    std::thread threadGLay(processLayer, std::ref(GLay), std::ref(g_b_key));
-    std::thread threadBLay(processLayer, std::ref(BLay), std::ref(b_b_key));
-
-    threadRLay.join();
-    threadGLay.join();
-    threadBLay.join();
+    Executor::instance().invoke(
+        [&] { processLayer(RLay, r_b_key); },
+        [&] { processLayer(GLay, g_b_key); },
+        [&] { processLayer(BLay, b_b_key); });
 }
 
 void WM::revPOB() {
-
     auto restoreLayer = [&](std::vector<WMPixel>& layer, const std::vector<unsigned char>& key) {
-        for (size_t i = 0; i < size; ++i) {
-            unsigned char keyValue = key[i]; // Значение ключа (r_b_key, g_b_key, b_b_key)
-            unsigned char compressedLowBits = layer[i].lowBits; // Сжатое значение lowBits
-
-            if (keyValue < 5 && compressedLowBits < sizeof(REV_LOW_BITS_LUT[keyValue]) / sizeof(REV_LOW_BITS_LUT[keyValue][0])) {
-                layer[i].lowBits = REV_LOW_BITS_LUT[keyValue][compressedLowBits];
-            } else {
-                layer[i].lowBits = 0; 
-            }
-        }
+        simd::kernels().rev_pob(reinterpret_cast<unsigned char*>(layer.data()), key.data(), size);
     };
 
-    std::thread threadRLay(restoreLayer, std::ref(RLay), std::ref(r_b_key));
-    std::thread threadGLay(restoreLayer, std::ref(GLay), std::ref(g_b_key));
-    std::thread threadBLay(restoreLayer, std::ref(BLay), std::ref(b_b_key));
-
-    threadRLay.join();
-    threadGLay.join();
-    threadBLay.join();
+    Executor::instance().invoke(
+        [&] { restoreLayer(RLay, r_b_key); },
+        [&] { restoreLayer(GLay, g_b_key); },
+        [&] { restoreLayer(BLay, b_b_key); });
 }
 
 WM::WM() {
@@ -55,13 +38,10 @@ WM::WM() {
         }
     };
 
-    std::thread threadRLay(processLayer, std::ref(r_lay), std::ref(RLay));
-    std::thread threadGLay(processLayer, std::ref(g_lay), std::ref(GLay));
-    std::thread threadBLay(processLayer, std::ref(b_lay), std::ref(BLay));
-
-    threadRLay.join();
-    threadGLay.join();
-    threadBLay.join();
+    Executor::instance().invoke(
+        [&] { processLayer(r_lay, RLay); },
+        [&] { processLayer(g_lay, GLay); },
+        [&] { processLayer(b_lay, BLay); });
 }
 
 WM::~WM() {
@@ -71,13 +51,10 @@ WM::~WM() {
         }
     };
 
-    std::thread threadRLay(mergeLayer, std::ref(RLay), std::ref(r_lay));
-    std::thread threadGLay(mergeLayer, std::ref(GLay), std::ref(g_lay));
-    std::thread threadBLay(mergeLayer, std::ref(BLay), std::ref(b_lay));
-
-    threadRLay.join();
-    threadGLay.join();
-    threadBLay.join();
+    Executor::instance().invoke(
+        [&] { mergeLayer(RLay, r_lay); },
+        [&] { mergeLayer(GLay, g_lay); },
+        [&] { mergeLayer(BLay, b_lay); });
 }
 
 void WM::AffineTransformation() {
@@ -100,13 +77,10 @@ void WM::AffineTransformation() {
         layer = std::move(new_layer);
     };
 
-    std::thread threadR(transformLayer, std::ref(r_lay));
-    std::thread threadG(transformLayer, std::ref(g_lay));
-    std::thread threadB(transformLayer, std::ref(b_lay));
-
-    threadR.join();
-    threadG.join();
-    threadB.join();
+    Executor::instance().invoke(
+        [&] { transformLayer(r_lay); },
+        [&] { transformLayer(g_lay); },
+        [&] { transformLayer(b_lay); });
 }
 
 
@@ -159,11 +133,38 @@ void WM::revAffineTransformation() {
         layer = std::move(original_layer);
     };
 
-    std::thread threadR(inverseTransformLayer, std::ref(r_lay));
-    std::thread threadG(inverseTransformLayer, std::ref(g_lay));
-    std::thread threadB(inverseTransformLayer, std::ref(b_lay));
+    Executor::instance().invoke(
+        [&] { inverseTransformLayer(r_lay); },
+        [&] { inverseTransformLayer(g_lay); },
+        [&] { inverseTransformLayer(b_lay); });
+}
+
+PackedWM::PackedWM(const WM& wm) : width(wm.width), height(wm.height), pixels(wm.r_lay.size()) {
+    const std::vector<unsigned char>* source[3] = {&wm.r_lay, &wm.g_lay, &wm.b_lay};
+    std::vector<uint64_t>* target[3] = {&r_bits, &g_bits, &b_bits};
+    const simd::Kernels& kernels = simd::kernels();
+
+    for (int c = 0; c < 3; ++c) {
+        if (source[c]->size() != pixels) throw std::invalid_argument("PackedWM: слои разного размера");
+        target[c]->resize(words());
+        kernels.pack_bits(source[c]->data(), pixels, target[c]->data());
+        ones[c] = kernels.bit_stats(target[c]->data(), target[c]->data(), words()).common;
+    }
+}
 
-    threadR.join();
-    threadG.join();
-    threadB.join();
-}
\ No newline at end of file
+void PackedWM::unpack_into(WM& wm) const {
+    const std::vector<uint64_t>* source[3] = {&r_bits, &g_bits, &b_bits};
+    std::vector<unsigned char>* target[3] = {&wm.r_lay, &wm.g_lay, &wm.b_lay};
+
+    wm.width = width;
+    wm.height = height;
+    wm.channels = 3;
+    for (int c = 0; c < 3; ++c) {
+        std::vector<unsigned char>& layer = *target[c];
+        layer.resize(pixels);
+        for (size_t i = 0; i < pixels; ++i) {
+            layer[i] = ((*source[c])[i / 64] >> (i % 64)) & 1 ? 255 : 0;
+        }
+    }
+    wm.layers_to_pix_vec();
+}
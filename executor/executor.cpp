@@ -0,0 +1,147 @@
+#include "executor.hpp"
+#include <algorithm>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void Executor::Job::work() {
+    for (;;) {
+        const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count) break;
+
+        if (!failed.load(std::memory_order_relaxed)) {
+            try {
+                invoke(context, i);
+            } catch (...) {
+                if (!failed.exchange(true)) error = std::current_exception();
+            }
+        }
+        done.fetch_add(1, std::memory_order_release);
+    }
+}
+
+Executor::Executor(size_t workers) : queues(workers) {
+    parallelism = workers;
+    threads.reserve(workers);
+    for (size_t id = 0; id < workers; ++id) {
+        threads.emplace_back(&Executor::worker, this, id);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+Executor& Executor::instance() {
+    static std::mutex guard;
+    static std::atomic<Executor*> current{nullptr};
+    static std::atomic<pid_t> owner{0};
+
+    // Быстрый путь без блокировки: instance() вызывается из каждого потока
+    // OpenMP на пути целевой функции. owner записывается раньше указателя
+    const pid_t self = getpid();
+    Executor* pool = current.load(std::memory_order_acquire);
+    if (pool != nullptr && owner.load(std::memory_order_relaxed) == self) return *pool;
+
+    std::lock_guard<std::mutex> lock(guard);
+    pool = current.load(std::memory_order_relaxed);
+    if (pool == nullptr || owner.load(std::memory_order_relaxed) != self) {
+        // Пул родителя после fork() не освобождается: его потоки и
+        // состояние мьютексов в дочернем процессе недействительны
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        pool = new Executor(hardware - 1);
+        owner.store(self, std::memory_order_relaxed);
+        current.store(pool, std::memory_order_release);
+    }
+    return *pool;
+}
+
+void Executor::setParallelism(size_t helpers) {
+    parallelism = std::min(helpers, threads.size());
+}
+
+bool Executor::inlineOnly() const {
+    if (threads.empty() || parallelism.load(std::memory_order_relaxed) == 0) return true;
+#ifdef _OPENMP
+    if (omp_in_parallel()) return true;
+#endif
+    return false;
+}
+
+void Executor::run(Job& job) {
+    // Слоты бюджета берутся без ожидания: сколько свободно, столько и помощников
+    const size_t wanted = std::min(job.count - 1, threads.size());
+    size_t taken = 0;
+    size_t current = busy.load(std::memory_order_relaxed);
+    for (;;) {
+        const size_t limit = parallelism.load(std::memory_order_relaxed);
+        taken = (current < limit) ? std::min(wanted, limit - current) : 0;
+        if (taken == 0 || busy.compare_exchange_weak(current, current + taken, std::memory_order_relaxed)) break;
+    }
+
+    job.helpers.store(taken, std::memory_order_relaxed);
+    if (taken > 0) {
+        // Счётчик растёт раньше, чем задачи попадают в очереди: иначе
+        // рабочий успел бы взять задачу и уменьшить его ниже нуля
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            pending.fetch_add(taken, std::memory_order_relaxed);
+        }
+        for (size_t k = 0; k < taken; ++k) {
+            queues[next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size()].push(&job);
+        }
+        wake.notify_all();
+    }
+
+    job.work();
+
+    // Пока помощники не вернули задачи, job нельзя разрушать; ждущий поток
+    // сам выполняет задачи из очередей, в том числе ещё не взятые свои.
+    // Когда очереди пусты, все оставшиеся задачи уже у других потоков — ждём их.
+    // Ожидание всегда проходит через мьютекс job: последний помощник отпускает
+    // его после уведомления, и только тогда job можно разрушить
+    while (job.helpers.load(std::memory_order_acquire) != 0 && runOne(SIZE_MAX)) {}
+    {
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.finished.wait(lock, [&job] { return job.helpers.load(std::memory_order_acquire) == 0; });
+    }
+
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+bool Executor::runOne(size_t home) {
+    std::optional<Job*> task;
+    if (home < queues.size()) task = queues[home].pop();
+    for (size_t k = 0; !task && k < queues.size(); ++k) {
+        task = queues[(home + 1 + k) % queues.size()].steal();
+    }
+    if (!task) return false;
+
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    Job* job = *task;
+    job->work();
+    busy.fetch_sub(1, std::memory_order_relaxed);
+    {
+        // Под мьютексом job: вызывающий не разрушит job, пока уведомление не отправлено
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->helpers.fetch_sub(1, std::memory_order_release) == 1) job->finished.notify_all();
+    }
+    return true;
+}
+
+void Executor::worker(size_t id) {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (runOne(id)) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping.load() || pending.load() > 0; });
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "work_stealing_deque.hpp"
+
+// Общий для всего проекта пул потоков с кражей задач. Потоки создаются
+// один раз; parallel_for раздаёт индексы через общий счётчик, вызывающий
+// поток работает наравне с помощниками и, дожидаясь их, сам выполняет
+// задачи из очередей, поэтому вложенные вызовы не блокируются.
+//
+// Бюджет параллелизма ограничивает число помощников, одновременно занятых
+// во всех вызовах: когда он исчерпан, вызов выполняется в текущем потоке.
+// Внутри параллельной области OpenMP вызовы всегда выполняются на месте —
+// ядра уже заняты внешним уровнем.
+//
+// После fork() дочерний процесс при первом обращении к instance()
+// получает новый пул: потоки родителя в нём не существуют.
+class Executor {
+public:
+    explicit Executor(size_t workers);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    static Executor& instance();
+
+    size_t workers() const { return threads.size(); }
+
+    // Наибольшее число помощников сразу (не больше workers())
+    void setParallelism(size_t helpers);
+    size_t getParallelism() const { return parallelism.load(std::memory_order_relaxed); }
+
+    // fn(i) для i из [0, n); первое исключение пробрасывается вызывающему
+    template <typename Fn>
+    void parallel_for(size_t n, Fn&& fn) {
+        if (n == 0) return;
+        if (n == 1 || inlineOnly()) {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+
+        Job job;
+        job.count = n;
+        job.context = &fn;
+        job.invoke = [](void* context, size_t i) { (*static_cast<std::remove_reference_t<Fn>*>(context))(i); };
+        run(job);
+    }
+
+    // Несколько независимых действий, например по одному на канал
+    template <typename... Fns>
+    void invoke(Fns&&... fns) {
+        auto dispatch = [&](size_t i) {
+            size_t k = 0;
+            ((k++ == i ? static_cast<void>(fns()) : static_cast<void>(0)), ...);
+        };
+        parallel_for(sizeof...(Fns), dispatch);
+    }
+
+private:
+    struct Job {
+        size_t count = 0;
+        void* context = nullptr;
+        void (*invoke)(void*, size_t) = nullptr;
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<size_t> helpers{0};      // помощники, ещё не вернувшие слот
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mutex;                    // ожидание вызывающим последних помощников
+        std::condition_variable finished;
+
+        void work();
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<WorkStealingDeque<Job*>> queues;
+    std::atomic<size_t> parallelism{0};
+    std::atomic<size_t> busy{0};             // занятые слоты бюджета
+    std::atomic<size_t> pending{0};          // задач в очередях
+    std::atomic<size_t> next_queue{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+    bool inlineOnly() const;
+    void run(Job& job);
+    bool runOne(size_t home);
+    void worker(size_t id);
+};
+
+#endif // EXECUTOR_HPP
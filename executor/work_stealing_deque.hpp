@@ -0,0 +1,44 @@
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Очередь задач одного рабочего потока: владелец кладёт и берёт задачи
+// с конца (LIFO, горячие данные), остальные потоки крадут с начала (FIFO)
+template <typename T>
+class WorkStealingDeque {
+public:
+    void push(T task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+
+    std::optional<T> pop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return std::nullopt;
+        T task = std::move(tasks.back());
+        tasks.pop_back();
+        return task;
+    }
+
+    std::optional<T> steal() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return std::nullopt;
+        T task = std::move(tasks.front());
+        tasks.pop_front();
+        return task;
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.empty();
+    }
+
+private:
+    std::deque<T> tasks;
+    mutable std::mutex mutex;
+};
+
+#endif // WORK_STEALING_DEQUE_HPP
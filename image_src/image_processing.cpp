@@ -4,8 +4,11 @@
 #include "lib/stb_image.h"
 #include "lib/md5.hpp"
 #include "image_processing.hpp"
+#include "executor/executor.hpp"
+#include "simd/dispatch.hpp"
 #include <vector>
 #include <iostream>
+#include <stdexcept>
 
 std::vector<unsigned char> Image::import_image(const std::string& filepath) {
     unsigned char* data = stbi_load(filepath.c_str(), &this->width, &this->height, &this->channels, 0);
@@ -73,21 +76,10 @@ void Image::process_channel_to_blocks(
 }
 
 void Image::lay_to_blocks() {
-    std::thread thread_r([this]() { 
-        process_channel_to_blocks(r_lay, r_lay_blocks); 
-    });
-    
-    std::thread thread_g([this]() { 
-        process_channel_to_blocks(g_lay, g_lay_blocks); 
-    });
-    
-    std::thread thread_b([this]() { 
-        process_channel_to_blocks(b_lay, b_lay_blocks); 
-    });
-
-    thread_r.join();
-    thread_g.join();
-    thread_b.join();
+    Executor::instance().invoke(
+        [this] { process_channel_to_blocks(r_lay, r_lay_blocks); },
+        [this] { process_channel_to_blocks(g_lay, g_lay_blocks); },
+        [this] { process_channel_to_blocks(b_lay, b_lay_blocks); });
 }
 
 void Image::blocks_to_lay() {
@@ -129,6 +121,33 @@ void Image::blocks_to_lay() {
     process_blocks_to_channel(b_lay_blocks, b_lay);
 }
 
+void Image::downscale_into(Image& dst, bool average, int align) const {
+    dst.width = (width / 2) / align * align;
+    dst.height = (height / 2) / align * align;
+    dst.channels = channels;
+    dst.image_vec.assign(static_cast<size_t>(dst.width) * dst.height * channels, 0);
+
+    for (int y = 0; y < dst.height; ++y) {
+        const unsigned char* row0 = image_vec.data() + static_cast<size_t>(2 * y) * width * channels;
+        const unsigned char* row1 = row0 + static_cast<size_t>(width) * channels;
+        unsigned char* out = dst.image_vec.data() + static_cast<size_t>(y) * dst.width * channels;
+
+        for (int x = 0; x < dst.width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                const size_t left = static_cast<size_t>(2 * x) * channels + c;
+                if (average) {
+                    const int sum = row0[left] + row0[left + channels] + row1[left] + row1[left + channels];
+                    out[x * channels + c] = static_cast<unsigned char>((sum + 2) >> 2);
+                } else {
+                    out[x * channels + c] = row0[left];
+                }
+            }
+        }
+    }
+
+    dst.pix_vec_to_layers();
+}
+
 void Image::hadamard_trans() {
     std::array<std::array<double, 4>, 4> hadamard_matrix = {{
         {1,  1,  1,  1},
@@ -224,27 +243,9 @@ std::array<std::array<double, 4>, 4> Image::multiply_matrices(const std::array<s
         throw std::invalid_argument("Невозможно умножить матрицы: несовместимые размеры");
     }
 
-    // Размеры результирующей матрицы
-    size_t rows1 = matrix1.size();       // Количество строк в первой матрице
-    size_t cols2 = matrix2[0].size();    // Количество столбцов во второй матрице
-    size_t commonSize = matrix2.size();  // Общий размер (столбцы первой матрицы и строки второй)
-
-    // Инициализация результирующей матрицы нулями
-    std::array<std::array<double, 4>, 4> result = {{
-    {0, 0, 0, 0},
-    {0, 0, 0, 0},
-    {0, 0, 0, 0},
-    {0, 0, 0, 0}
-    }};
-
-    // Умножение матриц
-    for (size_t i = 0; i < rows1; ++i) {
-        for (size_t j = 0; j < cols2; ++j) {
-            for (size_t k = 0; k < commonSize; ++k) {
-                result[i][j] += matrix1[i][k] * matrix2[k][j];
-            }
-        }
-    }
+    // Матрицы 4x4 лежат в памяти построчно и непрерывно
+    std::array<std::array<double, 4>, 4> result;
+    simd::kernels().multiply4x4(matrix1[0].data(), matrix2[0].data(), result[0].data());
 
     return result;
 }
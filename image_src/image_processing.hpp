@@ -5,7 +5,6 @@
 #include <array>
 #include <vector>
 #include <iostream>
-#include <thread>
 
 using Block = std::array<std::array<unsigned char, 4>, 4>;
 using Block_hadamard = std::array<std::array<double, 4>, 4>;
@@ -52,6 +51,11 @@ public:
     void lay_to_blocks();
     void blocks_to_lay();
 
+    // Уменьшение вдвое усреднением 2x2 (average = false — выборкой левого верхнего
+    // пикселя, для бинарных ЦВЗ). Размеры округляются вниз до кратных align,
+    // чтобы разбиение на блоки 4x4 сохранялось.
+    void downscale_into(Image& dst, bool average = true, int align = 4) const;
+
     std::array<std::array<double, 4>, 4> multiply_matrices(const std::array<std::array<double, 4>, 4>& matrix1, const std::array<std::array<double, 4>, 4>& matrix2);
 
 private:
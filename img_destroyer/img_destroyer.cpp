@@ -1,4 +1,5 @@
 #include "img_destroyer.hpp"
+#include "simd/dispatch.hpp"
 #include <algorithm>
 #include <stdexcept>
 
@@ -127,20 +128,15 @@ void ImageDestroyer::mergeFromBlocks(const std::vector<Block8x8<Pixel>>& blocks)
     }
 }
 
+static_assert(sizeof(Block8x8<Pixel>) == 64 * 3, "пиксели RGB в блоке должны идти подряд по байту");
+static_assert(sizeof(Block8x8<YCbCrPixel>) == 64 * 3 * sizeof(double), "пиксели YCbCr в блоке должны идти подряд");
+
 // Преобразование RGB → YCbCr (работает с блоками)
 void ImageDestroyer::convertToYCbCr() {
+    const simd::Kernels& kernels = simd::kernels();
     m_ycbcr_blocks.resize(m_rgb_blocks.size());
     for (size_t i = 0; i < m_rgb_blocks.size(); ++i) {
-        for (int y = 0; y < 8; ++y) {
-            for (int x = 0; x < 8; ++x) {
-                const Pixel& p = m_rgb_blocks[i][y][x];
-                YCbCrPixel ycbcr;
-                ycbcr.Y  = 0.299 * p.r + 0.587 * p.g + 0.114 * p.b;
-                ycbcr.Cb = 128 + (-0.168736 * p.r - 0.331264 * p.g + 0.5 * p.b);
-                ycbcr.Cr = 128 + (0.5 * p.r - 0.418688 * p.g - 0.081312 * p.b);
-                m_ycbcr_blocks[i][y][x] = ycbcr;
-            }
-        }
+        kernels.rgb_to_ycbcr(&m_rgb_blocks[i][0][0].r, &m_ycbcr_blocks[i][0][0].Y, 64);
     }
 }
 
@@ -150,20 +146,9 @@ void ImageDestroyer::convertToRGB() {
         throw std::runtime_error("YCbCr blocks are empty");
     }
 
+    const simd::Kernels& kernels = simd::kernels();
     for (size_t i = 0; i < m_ycbcr_blocks.size(); ++i) {
-        for (int y = 0; y < 8; ++y) {
-            for (int x = 0; x < 8; ++x) {
-                const YCbCrPixel& ycbcr = m_ycbcr_blocks[i][y][x];
-                double r = ycbcr.Y + 1.402 * (ycbcr.Cr - 128);
-                double g = ycbcr.Y - 0.344136 * (ycbcr.Cb - 128) - 0.714136 * (ycbcr.Cr - 128);
-                double b = ycbcr.Y + 1.772 * (ycbcr.Cb - 128);
-                m_rgb_blocks[i][y][x] = Pixel(
-                    static_cast<unsigned char>(std::clamp(r, 0.0, 255.0)),
-                    static_cast<unsigned char>(std::clamp(g, 0.0, 255.0)),
-                    static_cast<unsigned char>(std::clamp(b, 0.0, 255.0))
-                );
-            }
-        }
+        kernels.ycbcr_to_rgb(&m_ycbcr_blocks[i][0][0].Y, &m_rgb_blocks[i][0][0].r, 64);
     }
     mergeFromBlocks(m_rgb_blocks); // Обновляем изображение
 }
@@ -1,68 +1,24 @@
 #include "metrics.hpp"
+#include "executor/executor.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+uint64_t channel_squared_error(const unsigned char* a, const unsigned char* b, size_t n) {
+    return simd::kernels().squared_error(a, b, n);
+}
 
 double channel_mse(const std::vector<unsigned char>& old_img, const std::vector<unsigned char>& new_img) {
     const size_t total_pixels = old_img.size();
-    const size_t simd_step = 32;
-    __m256d sum = _mm256_setzero_pd();
-    size_t i = 0;
-
-    #pragma omp parallel for reduction(+:sum)
-    for (i = 0; i <= total_pixels - simd_step; i += simd_step) {
-        // Загрузка 32 байт
-        __m256i old_data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&old_img[i]));
-        __m256i new_data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&new_img[i]));
-
-        // Вычисление разности
-        __m256i diff = _mm256_sub_epi8(old_data, new_data);
-
-        // Возведение в квадрат (8-бит -> 16-бит)
-        __m256i square = _mm256_maddubs_epi16(diff, diff);
-
-        // Разделение на 128-битные части
-        __m128i square_low = _mm256_extracti128_si256(square, 0);
-        __m128i square_high = _mm256_extracti128_si256(square, 1);
-
-        // Конвертация 16-бит -> 32-бит
-        __m128i square_low_32 = _mm_cvtepi16_epi32(square_low);
-        __m128i square_high_32 = _mm_cvtepi16_epi32(square_high);
-
-        // Конвертация в double и суммирование
-        __m256d square_low_dbl = _mm256_cvtepi32_pd(square_low_32);
-        __m256d square_high_dbl = _mm256_cvtepi32_pd(square_high_32);
-
-        sum = _mm256_add_pd(sum, square_low_dbl);
-        sum = _mm256_add_pd(sum, square_high_dbl);
-    }
-
-    // Обработка оставшихся пикселей
-    double tail_sum = 0.0;
-    for (; i < total_pixels; ++i) {
-        double diff = static_cast<double>(old_img[i]) - static_cast<double>(new_img[i]);
-        tail_sum += diff * diff;
-    }
-
-    // Суммирование результатов
-    double tmp[4];
-    _mm256_storeu_pd(tmp, sum);
-    return (tmp[0] + tmp[1] + tmp[2] + tmp[3] + tail_sum) / total_pixels;
+    if (total_pixels == 0) return 0.0;
+    return static_cast<double>(channel_squared_error(old_img.data(), new_img.data(), total_pixels)) / total_pixels;
 }
 
 double image_mse(const Image& original, const Image& distorted) {
-    // Устанавливаем количество потоков для OpenMP внутри channel_mse_optimized
-    omp_set_num_threads(2); // 2 потока на канал
-
-    // Запускаем асинхронные задачи для каждого канала
-    auto future_r = std::async(std::launch::async, channel_mse, 
-                              std::ref(original.r_lay), std::ref(distorted.r_lay));
-    auto future_g = std::async(std::launch::async, channel_mse, 
-                              std::ref(original.g_lay), std::ref(distorted.g_lay));
-    auto future_b = std::async(std::launch::async, channel_mse, 
-                              std::ref(original.b_lay), std::ref(distorted.b_lay));
-
-    // Дожидаемся результатов и усредняем
-    const double mse_r = future_r.get();
-    const double mse_g = future_g.get();
-    const double mse_b = future_b.get();
+    double mse_r = 0.0, mse_g = 0.0, mse_b = 0.0;
+    Executor::instance().invoke(
+        [&] { mse_r = channel_mse(original.r_lay, distorted.r_lay); },
+        [&] { mse_g = channel_mse(original.g_lay, distorted.g_lay); },
+        [&] { mse_b = channel_mse(original.b_lay, distorted.b_lay); });
 
     return (mse_r + mse_g + mse_b) / 3.0;
 }
@@ -75,135 +31,721 @@ double image_psnr(const Image& original, const Image& distorted) {
 }
 
 double channel_nc(const std::vector<unsigned char>& orig, const std::vector<unsigned char>& extr) {
-    double sum_prod = 0.0;
-    double sum_sq_orig = 0.0;
-    double sum_sq_extr = 0.0;
-
-    #pragma omp parallel for reduction(+:sum_prod, sum_sq_orig, sum_sq_extr)
-    for (size_t i = 0; i < orig.size(); ++i) {
-        const double o = orig[i];
-        const double e = extr[i];
-        
-        sum_prod += o * e;
-        sum_sq_orig += o * o;
-        sum_sq_extr += e * e;
-    }
-
-    const double denominator = sqrt(sum_sq_orig * sum_sq_extr);
-    return (denominator > 1e-9) ? (sum_prod / denominator) : 0.0;
+    const simd::ByteStats stats = simd::kernels().byte_stats(orig.data(), extr.data(), orig.size());
+    const double denominator = sqrt(static_cast<double>(stats.aa) * static_cast<double>(stats.bb));
+    return (denominator > 1e-9) ? (stats.ab / denominator) : 0.0;
 }
 
 double image_nc(const WM& original_wm, const WM& extracted_wm) {
-    auto future_r = std::async(std::launch::async, channel_nc, 
-                             std::ref(original_wm.r_lay), std::ref(extracted_wm.r_lay));
-    auto future_g = std::async(std::launch::async, channel_nc,
-                             std::ref(original_wm.g_lay), std::ref(extracted_wm.g_lay));
-    auto future_b = std::async(std::launch::async, channel_nc,
-                             std::ref(original_wm.b_lay), std::ref(extracted_wm.b_lay));
+    double nc_r = 0.0, nc_g = 0.0, nc_b = 0.0;
+    Executor::instance().invoke(
+        [&] { nc_r = channel_nc(original_wm.r_lay, extracted_wm.r_lay); },
+        [&] { nc_g = channel_nc(original_wm.g_lay, extracted_wm.g_lay); },
+        [&] { nc_b = channel_nc(original_wm.b_lay, extracted_wm.b_lay); });
 
-    return (future_r.get() + future_g.get() + future_b.get()) / 3.0;
+    return (nc_r + nc_g + nc_b) / 3.0;
 }
 
 double channel_ber(const std::vector<unsigned char>& original, const std::vector<unsigned char>& extracted) {
     if (original.empty()) return 0.0;
-    
-    size_t error_bits = 0;
+
     const size_t total_bits = original.size() * 8;
+    const simd::ByteStats stats = simd::kernels().byte_stats(original.data(), extracted.data(), original.size());
+    return static_cast<double>(stats.differing_bits) / total_bits;
+}
+
+double image_ber(const WM& original_wm, const WM& extracted_wm) {
+    double ber_r = 0.0, ber_g = 0.0, ber_b = 0.0;
+    Executor::instance().invoke(
+        [&] { ber_r = channel_ber(original_wm.r_lay, extracted_wm.r_lay); },
+        [&] { ber_g = channel_ber(original_wm.g_lay, extracted_wm.g_lay); },
+        [&] { ber_b = channel_ber(original_wm.b_lay, extracted_wm.b_lay); });
+
+    return (ber_r + ber_g + ber_b) / 3.0;
+}
 
-    #pragma omp parallel for reduction(+:error_bits)
-    for (size_t i = 0; i < original.size(); ++i) {
-        unsigned char diff = original[i] ^ extracted[i];
-        error_bits += __builtin_popcount(diff);
+namespace {
+
+// Средние по каналам NC (0/1) и BER упакованных ЦВЗ
+WMComparison compare_packed(const PackedWM& original, const PackedWM& extracted) {
+    if (original.pixels != extracted.pixels) throw std::invalid_argument("PackedWM: размеры ЦВЗ не совпадают");
+    const std::vector<uint64_t>* a[3] = {&original.r_bits, &original.g_bits, &original.b_bits};
+    const std::vector<uint64_t>* b[3] = {&extracted.r_bits, &extracted.g_bits, &extracted.b_bits};
+    const simd::Kernels& kernels = simd::kernels();
+    WMComparison result;
+    if (original.pixels == 0) return result;
+
+    for (int c = 0; c < 3; ++c) {
+        const simd::BitStats stats = kernels.bit_stats(a[c]->data(), b[c]->data(), original.words());
+        const double denominator = std::sqrt(static_cast<double>(original.ones[c]) * extracted.ones[c]);
+        result.nc += (denominator > 0.0) ? stats.common / denominator : 0.0;
+        result.ber += static_cast<double>(stats.differing) / original.pixels;
     }
 
-    return static_cast<double>(error_bits) / total_bits;
+    result.nc /= 3.0;
+    result.ber /= 3.0;
+    return result;
 }
 
-double image_ber(const WM& original_wm, const WM& extracted_wm) {
-    auto future_r = std::async(std::launch::async, channel_ber, 
-                             std::ref(original_wm.r_lay), std::ref(extracted_wm.r_lay));
-    auto future_g = std::async(std::launch::async, channel_ber,
-                             std::ref(original_wm.g_lay), std::ref(extracted_wm.g_lay));
-    auto future_b = std::async(std::launch::async, channel_ber,
-                             std::ref(original_wm.b_lay), std::ref(extracted_wm.b_lay));
+} // namespace
 
-    return (future_r.get() + future_g.get() + future_b.get()) / 3.0;
+double image_nc(const PackedWM& original_wm, const PackedWM& extracted_wm) {
+    return compare_packed(original_wm, extracted_wm).nc;
 }
 
-double calculate_window_ssim(
-    const std::vector<unsigned char>& img1,
-    const std::vector<unsigned char>& img2,
-    int width, int x, int y) 
-{
-    double mu1 = 0.0, mu2 = 0.0;
-    double sigma1_sq = 0.0, sigma2_sq = 0.0, sigma12 = 0.0;
-
-    for (int dy = 0; dy < WINDOW_SIZE; ++dy) {
-        for (int dx = 0; dx < WINDOW_SIZE; ++dx) {
-            int idx = (y + dy) * width + (x + dx);
-            double val1 = img1[idx];
-            double val2 = img2[idx];
-            
-            mu1 += val1;
-            mu2 += val2;
-        }
-    }
-    
-    const double window_pixels = WINDOW_SIZE * WINDOW_SIZE;
-    mu1 /= window_pixels;
-    mu2 /= window_pixels;
-
-    for (int dy = 0; dy < WINDOW_SIZE; ++dy) {
-        for (int dx = 0; dx < WINDOW_SIZE; ++dx) {
-            int idx = (y + dy) * width + (x + dx);
-            double val1 = img1[idx] - mu1;
-            double val2 = img2[idx] - mu2;
-            
-            sigma1_sq += val1 * val1;
-            sigma2_sq += val2 * val2;
-            sigma12 += val1 * val2;
-        }
-    }
-    
-    sigma1_sq /= window_pixels - 1;
-    sigma2_sq /= window_pixels - 1;
-    sigma12 /= window_pixels - 1;
+double image_ber(const PackedWM& original_wm, const PackedWM& extracted_wm) {
+    return compare_packed(original_wm, extracted_wm).ber;
+}
+
+double image_nc_bipolar(const PackedWM& original_wm, const PackedWM& extracted_wm) {
+    return 1.0 - 2.0 * compare_packed(original_wm, extracted_wm).ber;
+}
+
+double window_ssim(const simd::WindowSums& w, int pixels) {
+    const double n = pixels;
+    const double mu1 = w.x / n;
+    const double mu2 = w.y / n;
+    const double sigma1_sq = (w.xx - w.x * mu1) / (n - 1);
+    const double sigma2_sq = (w.yy - w.y * mu2) / (n - 1);
+    const double sigma12 = (w.xy - w.x * mu2) / (n - 1);
 
     const double numerator = (2 * mu1 * mu2 + C1) * (2 * sigma12 + C2);
     const double denominator = (mu1 * mu1 + mu2 * mu2 + C1) * (sigma1_sq + sigma2_sq + C2);
-    
     return numerator / denominator;
 }
 
+IntegralImages::IntegralImages(const unsigned char* img1, const unsigned char* img2, int width, int height)
+    : stride(width + 1), table(static_cast<size_t>(width + 1) * (height + 1)) {
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row1 = img1 + static_cast<size_t>(y) * width;
+        const unsigned char* row2 = img2 + static_cast<size_t>(y) * width;
+        const simd::WindowSums* above = table.data() + static_cast<size_t>(y) * stride;
+        simd::WindowSums* current = table.data() + static_cast<size_t>(y + 1) * stride;
+
+        simd::WindowSums row;
+        for (int x = 0; x < width; ++x) {
+            const int a = row1[x];
+            const int b = row2[x];
+            row.x += a;
+            row.y += b;
+            row.xx += a * a;
+            row.yy += b * b;
+            row.xy += a * b;
+
+            current[x + 1].x = above[x + 1].x + row.x;
+            current[x + 1].y = above[x + 1].y + row.y;
+            current[x + 1].xx = above[x + 1].xx + row.xx;
+            current[x + 1].yy = above[x + 1].yy + row.yy;
+            current[x + 1].xy = above[x + 1].xy + row.xy;
+        }
+    }
+}
+
+simd::WindowSums IntegralImages::window(int x, int y, int w, int h) const {
+    const simd::WindowSums& a = table[static_cast<size_t>(y) * stride + x];
+    const simd::WindowSums& b = table[static_cast<size_t>(y) * stride + x + w];
+    const simd::WindowSums& c = table[static_cast<size_t>(y + h) * stride + x];
+    const simd::WindowSums& d = table[static_cast<size_t>(y + h) * stride + x + w];
+
+    simd::WindowSums sums;
+    sums.x = d.x - b.x - c.x + a.x;
+    sums.y = d.y - b.y - c.y + a.y;
+    sums.xx = d.xx - b.xx - c.xx + a.xx;
+    sums.yy = d.yy - b.yy - c.yy + a.yy;
+    sums.xy = d.xy - b.xy - c.xy + a.xy;
+    return sums;
+}
+
+namespace {
+
+// Суммы одного окна window x window с левым верхним углом в a и b
+simd::WindowSums direct_window_sums(const unsigned char* a, const unsigned char* b, int width, int window) {
+    simd::WindowSums sums;
+    for (int dy = 0; dy < window; ++dy) {
+        const unsigned char* row1 = a + static_cast<size_t>(dy) * width;
+        const unsigned char* row2 = b + static_cast<size_t>(dy) * width;
+        for (int dx = 0; dx < window; ++dx) {
+            const int x = row1[dx];
+            const int y = row2[dx];
+            sums.x += x;
+            sums.y += y;
+            sums.xx += x * x;
+            sums.yy += y * y;
+            sums.xy += x * y;
+        }
+    }
+    return sums;
+}
+
+} // namespace
+
+// Таблицы сумм нужны только перекрывающимся окнам: без перекрытия каждый
+// пиксель читается не больше одного раза, и прямой подсчёт не требует памяти
 double channel_ssim(
     const std::vector<unsigned char>& img1,
     const std::vector<unsigned char>& img2,
-    int width, int height) 
+    int width, int height, const SSIMParams& params)
 {
+    if (params.window < 2 || params.stride < 1) {
+        throw std::invalid_argument("SSIM: окно должно быть не меньше 2, шаг — не меньше 1");
+    }
+    if (width < params.window || height < params.window) return 1.0;
+
+    const int pixels = params.window * params.window;
     double total_ssim = 0.0;
-    int windows = 0;
+    size_t windows = 0;
+
+    if (params.stride < params.window) {
+        const IntegralImages sums(img1.data(), img2.data(), width, height);
+        for (int y = 0; y + params.window <= height; y += params.stride) {
+            for (int x = 0; x + params.window <= width; x += params.stride) {
+                total_ssim += window_ssim(sums.window(x, y, params.window, params.window), pixels);
+                ++windows;
+            }
+        }
+    } else if (params.window == WINDOW_SIZE && params.stride == WINDOW_SIZE) {
+        // Соседние окна 8x8 — целой строкой окон через векторное ядро
+        const int windows_x = width / WINDOW_SIZE;
+        std::vector<simd::WindowSums> row(windows_x);
+        for (int y = 0; y + WINDOW_SIZE <= height; y += WINDOW_SIZE) {
+            const size_t offset = static_cast<size_t>(y) * width;
+            simd::kernels().window_sums(img1.data() + offset, img2.data() + offset, width, windows_x, row.data());
+            for (const simd::WindowSums& w : row) {
+                total_ssim += window_ssim(w, pixels);
+            }
+            windows += windows_x;
+        }
+    } else {
+        for (int y = 0; y + params.window <= height; y += params.stride) {
+            for (int x = 0; x + params.window <= width; x += params.stride) {
+                const size_t offset = static_cast<size_t>(y) * width + x;
+                const simd::WindowSums w = direct_window_sums(img1.data() + offset, img2.data() + offset, width, params.window);
+                total_ssim += window_ssim(w, pixels);
+                ++windows;
+            }
+        }
+    }
+
+    return total_ssim / windows;
+}
+
+double image_ssim(const Image& original, const Image& distorted, const SSIMParams& params) {
+    const int width = original.width, height = original.height;
+    double ssim_r = 0.0, ssim_g = 0.0, ssim_b = 0.0;
+    Executor::instance().invoke(
+        [&] { ssim_r = channel_ssim(original.r_lay, distorted.r_lay, width, height, params); },
+        [&] { ssim_g = channel_ssim(original.g_lay, distorted.g_lay, width, height, params); },
+        [&] { ssim_b = channel_ssim(original.b_lay, distorted.b_lay, width, height, params); });
+
+    return (ssim_r + ssim_g + ssim_b) / 3.0;
+}
+
+namespace {
+
+using Plane = SSIMReference::Plane;
+
+// Веса масштабов MS-SSIM из Wang et al., 2003
+constexpr double MS_SSIM_WEIGHTS[MS_SSIM_SCALES] = {0.0448, 0.2856, 0.3001, 0.2363, 0.1333};
+
+// Кольцевой буфер: GAUSSIAN_WINDOW строк по пять моментов. Ширина полосы
+// подобрана так, чтобы он занимал около 256 КБ (L2)
+constexpr size_t STRIP_BYTES = 256 * 1024;
+constexpr size_t STRIP_WIDTH = STRIP_BYTES / (GAUSSIAN_WINDOW * 5 * sizeof(float)) / 8 * 8;
+
+const float* gaussian_taps() {
+    static const std::vector<float> taps = [] {
+        std::vector<float> result(GAUSSIAN_WINDOW);
+        const int center = GAUSSIAN_WINDOW / 2;
+        double total = 0.0;
+        for (int k = 0; k < GAUSSIAN_WINDOW; ++k) {
+            total += std::exp(-(k - center) * (k - center) / (2.0 * GAUSSIAN_SIGMA * GAUSSIAN_SIGMA));
+        }
+        for (int k = 0; k < GAUSSIAN_WINDOW; ++k) {
+            result[k] = static_cast<float>(
+                std::exp(-(k - center) * (k - center) / (2.0 * GAUSSIAN_SIGMA * GAUSSIAN_SIGMA)) / total);
+        }
+        return result;
+    }();
+    return taps.data();
+}
+
+Plane to_plane(const std::vector<unsigned char>& channel, int width, int height) {
+    if (channel.size() != static_cast<size_t>(width) * height) {
+        throw std::invalid_argument("SSIM: размеры изображений не совпадают");
+    }
+    return Plane{width, height, std::vector<float>(channel.begin(), channel.end())};
+}
+
+// Усреднение 2x2; нечётные последние строка и столбец отбрасываются
+Plane downsample(const Plane& src) {
+    Plane dst{src.width / 2, src.height / 2, {}};
+    dst.data.resize(static_cast<size_t>(dst.width) * dst.height);
+    for (int y = 0; y < dst.height; ++y) {
+        const float* row0 = src.data.data() + static_cast<size_t>(2 * y) * src.width;
+        const float* row1 = row0 + src.width;
+        float* out = dst.data.data() + static_cast<size_t>(y) * dst.width;
+        for (int x = 0; x < dst.width; ++x) {
+            out[x] = 0.25f * ((row0[2 * x] + row0[2 * x + 1]) + (row1[2 * x] + row1[2 * x + 1]));
+        }
+    }
+    return dst;
+}
+
+bool fits_window(const Plane& plane) {
+    return plane.width >= GAUSSIAN_WINDOW && plane.height >= GAUSSIAN_WINDOW;
+}
 
-    #pragma omp parallel for reduction(+:total_ssim, windows)
-    for (int y = 0; y <= height - WINDOW_SIZE; y += WINDOW_SIZE) {
-        for (int x = 0; x <= width - WINDOW_SIZE; x += WINDOW_SIZE) {
-            double ssim = calculate_window_ssim(img1, img2, width, x, y);
-            total_ssim += ssim;
-            windows++;
+struct ScaleSSIM {
+    double ssim = 0.0;  // среднее l·cs
+    double cs = 0.0;    // среднее contrast-structure
+};
+
+ScaleSSIM gaussian_scale(const Plane& a, const Plane& b) {
+    const simd::Kernels& kernels = simd::kernels();
+    const float* taps = gaussian_taps();
+    const size_t window = GAUSSIAN_WINDOW;
+    const size_t out_width = a.width - window + 1;
+    const size_t out_height = a.height - window + 1;
+    const size_t strip = std::min(out_width, STRIP_WIDTH);
+
+    // ring[q * window + slot] — строка момента q (x, y, x², y², xy) после фильтра по строке
+    std::vector<float> ring(5 * window * strip);
+    std::vector<float> moments(5 * strip);     // после фильтра по столбцу
+    std::vector<float> ssim_row(strip), cs_row(strip);
+    auto ring_row = [&](size_t q, size_t slot) { return ring.data() + (q * window + slot) * strip; };
+    auto moment = [&](size_t q) { return moments.data() + q * strip; };
+
+    ScaleSSIM result;
+    for (size_t x0 = 0; x0 < out_width; x0 += strip) {
+        const size_t width = std::min(strip, out_width - x0);
+
+        for (size_t y = 0; y < static_cast<size_t>(a.height); ++y) {
+            const size_t slot = y % window;
+            kernels.moment_rows(a.data.data() + y * a.width + x0, b.data.data() + y * b.width + x0,
+                                width, taps, window,
+                                ring_row(0, slot), ring_row(1, slot), ring_row(2, slot),
+                                ring_row(3, slot), ring_row(4, slot));
+            if (y + 1 < window) continue;
+
+            const size_t top = y + 1 - window;
+            for (size_t q = 0; q < 5; ++q) {
+                const float* rows[GAUSSIAN_WINDOW];
+                for (size_t k = 0; k < window; ++k) rows[k] = ring_row(q, (top + k) % window);
+                kernels.filter_columns(rows, taps, window, width, moment(q));
+            }
+            kernels.ssim_map(moment(0), moment(1), moment(2), moment(3), moment(4), width,
+                             static_cast<float>(C1), static_cast<float>(C2), ssim_row.data(), cs_row.data());
+
+            double ssim_sum = 0.0, cs_sum = 0.0;
+            for (size_t i = 0; i < width; ++i) {
+                ssim_sum += ssim_row[i];
+                cs_sum += cs_row[i];
+            }
+            result.ssim += ssim_sum;
+            result.cs += cs_sum;
         }
     }
 
-    return (windows > 0) ? total_ssim / windows : 1.0;
+    const double positions = static_cast<double>(out_width) * out_height;
+    result.ssim /= positions;
+    result.cs /= positions;
+    return result;
+}
+
+double channel_gaussian_ssim(const std::vector<Plane>& reference, const std::vector<unsigned char>& channel) {
+    if (reference.empty() || !fits_window(reference[0])) return 1.0;
+    const Plane distorted = to_plane(channel, reference[0].width, reference[0].height);
+    return gaussian_scale(reference[0], distorted).ssim;
+}
+
+double channel_ms_ssim(const std::vector<Plane>& reference, const std::vector<unsigned char>& channel) {
+    if (reference.empty() || !fits_window(reference[0])) return 1.0;
+    const int scales = static_cast<int>(reference.size());
+
+    double weight_sum = 0.0;
+    for (int s = 0; s < scales; ++s) weight_sum += MS_SSIM_WEIGHTS[s];
+
+    Plane distorted = to_plane(channel, reference[0].width, reference[0].height);
+    double result = 1.0;
+    for (int s = 0; s < scales; ++s) {
+        if (s > 0) distorted = downsample(distorted);
+        const ScaleSSIM scale = gaussian_scale(reference[s], distorted);
+        const double value = (s + 1 == scales) ? scale.ssim : scale.cs;
+        result *= std::pow(std::max(value, 0.0), MS_SSIM_WEIGHTS[s] / weight_sum);
+    }
+    return result;
+}
+
+} // namespace
+
+SSIMReference::SSIMReference(const Image& original, int scales) {
+    const std::vector<unsigned char>* source[3] = {&original.r_lay, &original.g_lay, &original.b_lay};
+    scales = std::clamp(scales, 1, MS_SSIM_SCALES);
+
+    Executor::instance().parallel_for(3, [&](size_t c) {
+        std::vector<Plane>& levels = pyramid[c];
+        levels.push_back(to_plane(*source[c], original.width, original.height));
+        while (static_cast<int>(levels.size()) < scales) {
+            Plane next = downsample(levels.back());
+            if (!fits_window(next)) break;
+            levels.push_back(std::move(next));
+        }
+    });
+}
+
+double SSIMReference::gaussian_ssim(const Image& distorted) const {
+    const std::vector<unsigned char>* target[3] = {&distorted.r_lay, &distorted.g_lay, &distorted.b_lay};
+    double ssim[3] = {0.0, 0.0, 0.0};
+    Executor::instance().parallel_for(3, [&](size_t c) { ssim[c] = channel_gaussian_ssim(pyramid[c], *target[c]); });
+    return (ssim[0] + ssim[1] + ssim[2]) / 3.0;
 }
 
-double image_ssim(const Image& original, const Image& distorted) {
-    auto future_r = std::async(std::launch::async, channel_ssim,
-        std::ref(original.r_lay), std::ref(distorted.r_lay), original.width, original.height);
-    
-    auto future_g = std::async(std::launch::async, channel_ssim,
-        std::ref(original.g_lay), std::ref(distorted.g_lay), original.width, original.height);
-    
-    auto future_b = std::async(std::launch::async, channel_ssim,
-        std::ref(original.b_lay), std::ref(distorted.b_lay), original.width, original.height);
+double SSIMReference::ms_ssim(const Image& distorted) const {
+    const std::vector<unsigned char>* target[3] = {&distorted.r_lay, &distorted.g_lay, &distorted.b_lay};
+    double ssim[3] = {0.0, 0.0, 0.0};
+    Executor::instance().parallel_for(3, [&](size_t c) { ssim[c] = channel_ms_ssim(pyramid[c], *target[c]); });
+    return (ssim[0] + ssim[1] + ssim[2]) / 3.0;
+}
+
+double image_gaussian_ssim(const Image& original, const Image& distorted) {
+    return SSIMReference(original, 1).gaussian_ssim(distorted);
+}
+
+double image_ms_ssim(const Image& original, const Image& distorted) {
+    return SSIMReference(original).ms_ssim(distorted);
+}
 
-    return (future_r.get() + future_g.get() + future_b.get()) / 3.0;
-}
\ No newline at end of file
+namespace {
+
+static_assert(WINDOW_SIZE == 8, "simd::Kernels::window_sums считает окна 8x8");
+
+struct ChannelQuality {
+    double mse = 0.0;
+    double ssim = 1.0;
+};
+
+struct QualitySums {
+    int64_t squared_error = 0;
+    double ssim = 0.0;
+    std::vector<simd::WindowSums> windows;   // суммы окон текущей полосы
+};
+
+// Полоса из WINDOW_SIZE строк канала (длина строки — width): окна 8x8
+// и столбцы правее последнего окна
+void band_quality(const simd::Kernels& kernels, const unsigned char* row1, const unsigned char* row2,
+                  int width, QualitySums& sums) {
+    const int windows_x = width / WINDOW_SIZE;
+    const int covered_width = windows_x * WINDOW_SIZE;
+    sums.windows.resize(windows_x);
+
+    kernels.window_sums(row1, row2, width, windows_x, sums.windows.data());
+    for (const simd::WindowSums& w : sums.windows) {
+        sums.squared_error += w.xx + w.yy - 2 * w.xy;
+        sums.ssim += window_ssim(w, WINDOW_SIZE * WINDOW_SIZE);
+    }
+
+    if (covered_width < width) {
+        for (int dy = 0; dy < WINDOW_SIZE; ++dy) {
+            sums.squared_error += kernels.squared_error(row1 + dy * width + covered_width,
+                                                        row2 + dy * width + covered_width, width - covered_width);
+        }
+    }
+}
+
+ChannelQuality finish_quality(const QualitySums& sums, size_t total_pixels, int width, int height) {
+    const int windows = (width / WINDOW_SIZE) * (height / WINDOW_SIZE);
+    ChannelQuality result;
+    result.mse = static_cast<double>(sums.squared_error) / total_pixels;
+    result.ssim = (windows > 0) ? sums.ssim / windows : 1.0;
+    return result;
+}
+
+ChannelQuality channel_quality(const std::vector<unsigned char>& img1, const std::vector<unsigned char>& img2,
+                               int width, int height) {
+    const size_t total_pixels = img1.size();
+    if (total_pixels == 0 || width <= 0) return {};
+
+    const int windows_y = height / WINDOW_SIZE;
+    const simd::Kernels& kernels = simd::kernels();
+    QualitySums sums;
+
+    for (int wy = 0; wy < windows_y; ++wy) {
+        const size_t offset = static_cast<size_t>(wy) * WINDOW_SIZE * width;
+        band_quality(kernels, img1.data() + offset, img2.data() + offset, width, sums);
+    }
+
+    // Строки ниже последнего окна
+    const size_t covered = static_cast<size_t>(windows_y) * WINDOW_SIZE * width;
+    sums.squared_error += kernels.squared_error(img1.data() + covered, img2.data() + covered, total_pixels - covered);
+
+    return finish_quality(sums, total_pixels, width, height);
+}
+
+ImageQuality to_image_quality(double mse, double ssim) {
+    ImageQuality quality;
+    quality.mse = mse;
+    quality.psnr = (mse <= 0.0)
+        ? std::numeric_limits<double>::infinity()
+        : 10.0 * std::log10(65025.0 / mse);
+    quality.ssim = ssim;
+    return quality;
+}
+
+} // namespace
+
+ImageQuality image_quality(const Image& original, const Image& distorted) {
+    const int width = original.width, height = original.height;
+    ChannelQuality r, g, b;
+    Executor::instance().invoke(
+        [&] { r = channel_quality(original.r_lay, distorted.r_lay, width, height); },
+        [&] { g = channel_quality(original.g_lay, distorted.g_lay, width, height); },
+        [&] { b = channel_quality(original.b_lay, distorted.b_lay, width, height); });
+
+    return to_image_quality((r.mse + g.mse + b.mse) / 3.0, (r.ssim + g.ssim + b.ssim) / 3.0);
+}
+
+RGBQuality interleaved_quality(const unsigned char* original, const unsigned char* distorted,
+                               int width, int height, size_t stride) {
+    RGBQuality result;
+    if (width <= 0 || height <= 0) return result;
+    if (stride < static_cast<size_t>(width) * 3) {
+        throw std::invalid_argument("interleaved_quality: строка короче 3·width байт");
+    }
+
+    const simd::Kernels& kernels = simd::kernels();
+    const size_t band_pixels = static_cast<size_t>(WINDOW_SIZE) * width;
+    // Полоса в каналах: [канал][строка полосы][x] для обоих изображений
+    std::vector<unsigned char> planes1(3 * band_pixels), planes2(3 * band_pixels);
+    auto plane = [&](std::vector<unsigned char>& planes, int c) { return planes.data() + c * band_pixels; };
+    auto split_rows = [&](int y, int rows) {
+        for (int dy = 0; dy < rows; ++dy) {
+            const size_t at = static_cast<size_t>(dy) * width;
+            kernels.deinterleave_rgb(original + (y + dy) * stride, width,
+                                     plane(planes1, 0) + at, plane(planes1, 1) + at, plane(planes1, 2) + at);
+            kernels.deinterleave_rgb(distorted + (y + dy) * stride, width,
+                                     plane(planes2, 0) + at, plane(planes2, 1) + at, plane(planes2, 2) + at);
+        }
+    };
+
+    QualitySums sums[3];
+    const int windows_y = height / WINDOW_SIZE;
+    for (int wy = 0; wy < windows_y; ++wy) {
+        split_rows(wy * WINDOW_SIZE, WINDOW_SIZE);
+        for (int c = 0; c < 3; ++c) {
+            band_quality(kernels, plane(planes1, c), plane(planes2, c), width, sums[c]);
+        }
+    }
+
+    // Строки ниже последнего окна
+    const int rest = height - windows_y * WINDOW_SIZE;
+    if (rest > 0) {
+        split_rows(windows_y * WINDOW_SIZE, rest);
+        for (int c = 0; c < 3; ++c) {
+            sums[c].squared_error += kernels.squared_error(plane(planes1, c), plane(planes2, c),
+                                                           static_cast<size_t>(rest) * width);
+        }
+    }
+
+    const size_t total_pixels = static_cast<size_t>(width) * height;
+    double mse = 0.0, ssim = 0.0;
+    for (int c = 0; c < 3; ++c) {
+        const ChannelQuality channel = finish_quality(sums[c], total_pixels, width, height);
+        result.channels[c] = to_image_quality(channel.mse, channel.ssim);
+        mse += channel.mse;
+        ssim += channel.ssim;
+    }
+    result.average = to_image_quality(mse / 3.0, ssim / 3.0);
+    return result;
+}
+
+RGBQuality interleaved_quality(const Image& original, const Image& distorted) {
+    const size_t expected = static_cast<size_t>(original.width) * original.height * 3;
+    if (original.channels != 3 || original.image_vec.size() != expected || distorted.image_vec.size() != expected) {
+        throw std::invalid_argument("interleaved_quality: ожидаются image_vec RGB одного размера");
+    }
+    return interleaved_quality(original.image_vec.data(), distorted.image_vec.data(),
+                               original.width, original.height, static_cast<size_t>(original.width) * 3);
+}
+
+namespace {
+
+constexpr int QUALITY_BLOCK = 4;   // сторона блоков *_blocks_coordinates
+static_assert(WINDOW_SIZE == 2 * QUALITY_BLOCK, "окно SSIM складывается из 2x2 блоков");
+
+int64_t squared_error_of(const simd::WindowSums& sums) {
+    return sums.xx + sums.yy - 2 * sums.xy;
+}
+
+simd::WindowSums add_sums(const simd::WindowSums& a, const simd::WindowSums& b) {
+    return {a.x + b.x, a.y + b.y, a.xx + b.xx, a.yy + b.yy, a.xy + b.xy};
+}
+
+} // namespace
+
+QualityAccumulator::QualityAccumulator(const Image& original, const Image& distorted)
+    : width(original.width), height(original.height),
+      blocks_x(original.width / QUALITY_BLOCK), blocks_y(original.height / QUALITY_BLOCK),
+      windows_x(original.width / WINDOW_SIZE), windows_y(original.height / WINDOW_SIZE) {
+    const std::vector<unsigned char>* source[3] = {&original.r_lay, &original.g_lay, &original.b_lay};
+    for (int c = 0; c < 3; ++c) {
+        if (source[c]->size() != static_cast<size_t>(width) * height) {
+            throw std::invalid_argument("QualityAccumulator: размер слоя не равен width·height");
+        }
+        channels[c].original = *source[c];
+    }
+    reset(distorted);
+}
+
+void QualityAccumulator::check_size(const Image& distorted) const {
+    const size_t pixels = static_cast<size_t>(width) * height;
+    if (distorted.r_lay.size() != pixels || distorted.g_lay.size() != pixels || distorted.b_lay.size() != pixels) {
+        throw std::invalid_argument("QualityAccumulator: размеры изображений не совпадают");
+    }
+}
+
+// SSIM окна 8x8 по суммам его четырёх блоков
+double QualityAccumulator::combined_ssim(const Channel& channel, size_t window) const {
+    const size_t wx = window % windows_x, wy = window / windows_x;
+    const simd::WindowSums* top = channel.blocks.data() + 2 * wy * blocks_x + 2 * wx;
+    const simd::WindowSums sums = add_sums(add_sums(top[0], top[1]), add_sums(top[blocks_x], top[blocks_x + 1]));
+    return window_ssim(sums, WINDOW_SIZE * WINDOW_SIZE);
+}
+
+// Всё заново, в том же порядке суммирования окон, что и image_quality
+void QualityAccumulator::rebuild(Channel& channel, const std::vector<unsigned char>& distorted) const {
+    const simd::Kernels& kernels = simd::kernels();
+    const unsigned char* a = channel.original.data();
+    const unsigned char* b = distorted.data();
+
+    channel.squared_error = kernels.squared_error(a, b, channel.original.size());
+    channel.blocks.resize(static_cast<size_t>(blocks_x) * blocks_y);
+    for (int by = 0; by < blocks_y; ++by) {
+        const size_t offset = static_cast<size_t>(by) * QUALITY_BLOCK * width;
+        kernels.block_sums(a + offset, b + offset, width, blocks_x, channel.blocks.data() + by * blocks_x);
+    }
+
+    channel.window_ssim.resize(static_cast<size_t>(windows_x) * windows_y);
+    channel.dirty.assign(channel.window_ssim.size(), 0);
+    channel.ssim_sum = 0.0;
+    for (size_t window = 0; window < channel.window_ssim.size(); ++window) {
+        channel.window_ssim[window] = combined_ssim(channel, window);
+        channel.ssim_sum += channel.window_ssim[window];
+    }
+    channel.drift = 0;
+}
+
+void QualityAccumulator::update_channel(Channel& channel, const std::vector<unsigned char>& distorted,
+                                        const std::vector<uint16_t>& blocks) const {
+    const simd::Kernels& kernels = simd::kernels();
+    const unsigned char* a = channel.original.data();
+    const unsigned char* b = distorted.data();
+    const size_t total_blocks = channel.blocks.size();
+
+    for (uint16_t index : blocks) {
+        if (index >= total_blocks) throw std::out_of_range("QualityAccumulator: номер блока вне изображения");
+    }
+
+    // Подряд идущие блоки одной строки — одним вызовом ядра
+    for (size_t i = 0; i < blocks.size();) {
+        const int bx = blocks[i] % blocks_x, by = blocks[i] / blocks_x;
+        size_t run = 1;
+        while (i + run < blocks.size() && blocks[i + run] == blocks[i] + run && bx + static_cast<int>(run) < blocks_x) {
+            ++run;
+        }
+
+        simd::WindowSums* first = channel.blocks.data() + blocks[i];
+        for (size_t k = 0; k < run; ++k) channel.squared_error -= squared_error_of(first[k]);
+        const size_t offset = static_cast<size_t>(by) * QUALITY_BLOCK * width + bx * QUALITY_BLOCK;
+        kernels.block_sums(a + offset, b + offset, width, run, first);
+        for (size_t k = 0; k < run; ++k) {
+            channel.squared_error += squared_error_of(first[k]);
+            const int wx = (bx + static_cast<int>(k)) / 2, wy = by / 2;
+            if (wx >= windows_x || wy >= windows_y) continue;
+            const size_t window = static_cast<size_t>(wy) * windows_x + wx;
+            if (!channel.dirty[window]) {
+                channel.dirty[window] = 1;
+                channel.dirty_windows.push_back(window);
+            }
+        }
+        i += run;
+    }
+
+    // Окна — после всех блоков: окно с несколькими задетыми блоками считается один раз
+    for (size_t window : channel.dirty_windows) {
+        channel.dirty[window] = 0;
+        const double ssim = combined_ssim(channel, window);
+        channel.ssim_sum += ssim - channel.window_ssim[window];
+        channel.window_ssim[window] = ssim;
+    }
+    channel.drift += channel.dirty_windows.size();
+    channel.dirty_windows.clear();
+
+    // Ошибка округления разностей не должна накапливаться: после стольких
+    // обновлений, сколько всего окон, сумма собирается заново (амортизированно O(1))
+    if (channel.drift > channel.window_ssim.size()) {
+        channel.ssim_sum = 0.0;
+        for (double ssim : channel.window_ssim) channel.ssim_sum += ssim;
+        channel.drift = 0;
+    }
+}
+
+void QualityAccumulator::update(const Image& distorted, const std::vector<uint16_t>& r_blocks,
+                                const std::vector<uint16_t>& g_blocks, const std::vector<uint16_t>& b_blocks) {
+    check_size(distorted);
+    Executor::instance().invoke(
+        [&] { update_channel(channels[0], distorted.r_lay, r_blocks); },
+        [&] { update_channel(channels[1], distorted.g_lay, g_blocks); },
+        [&] { update_channel(channels[2], distorted.b_lay, b_blocks); });
+}
+
+void QualityAccumulator::reset(const Image& distorted) {
+    check_size(distorted);
+    Executor::instance().invoke(
+        [&] { rebuild(channels[0], distorted.r_lay); },
+        [&] { rebuild(channels[1], distorted.g_lay); },
+        [&] { rebuild(channels[2], distorted.b_lay); });
+}
+
+ImageQuality QualityAccumulator::quality() const {
+    const size_t pixels = static_cast<size_t>(width) * height;
+    const size_t windows = static_cast<size_t>(windows_x) * windows_y;
+    if (pixels == 0) return to_image_quality(0.0, 1.0);
+
+    double mse = 0.0, ssim = 0.0;
+    for (const Channel& channel : channels) {
+        mse += static_cast<double>(channel.squared_error) / pixels;
+        ssim += (windows > 0) ? channel.ssim_sum / windows : 1.0;
+    }
+    return to_image_quality(mse / 3.0, ssim / 3.0);
+}
+
+WMReference::WMReference(const WM& original) {
+    const std::vector<unsigned char>* source[3] = {&original.r_lay, &original.g_lay, &original.b_lay};
+    for (int c = 0; c < 3; ++c) {
+        layers[c] = *source[c];
+        for (unsigned char v : layers[c]) {
+            norm_sq[c] += static_cast<int64_t>(v) * v;
+        }
+    }
+}
+
+WMComparison WMReference::compare(const WM& extracted) const {
+    const std::vector<unsigned char>* target[3] = {&extracted.r_lay, &extracted.g_lay, &extracted.b_lay};
+    const simd::Kernels& kernels = simd::kernels();
+    WMComparison result;
+
+    for (int c = 0; c < 3; ++c) {
+        const size_t size = layers[c].size();
+        if (target[c]->size() != size) throw std::invalid_argument("WMReference: размеры ЦВЗ не совпадают");
+        if (size == 0) continue;
+
+        const simd::ByteStats layer = kernels.cross_stats(layers[c].data(), target[c]->data(), size);
+        const double denominator = std::sqrt(static_cast<double>(norm_sq[c]) * static_cast<double>(layer.bb));
+        result.nc += (denominator > 1e-9) ? layer.ab / denominator : 0.0;
+        result.ber += static_cast<double>(layer.differing_bits) / (size * 8);
+    }
+
+    result.nc /= 3.0;
+    result.ber /= 3.0;
+    return result;
+}
@@ -2,21 +2,185 @@
 #define METRICS_HPP
 
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <cmath>
 #include <limits>
-#include <immintrin.h>  // Для AVX2
 #include "image_src/image_processing.hpp"
 #include "WM/WM.hpp"
-#include <omp.h>
-#include <future>
+#include "simd/dispatch.hpp"
+
+constexpr int WINDOW_SIZE = 8; // Окно SSIM по умолчанию и окно image_quality
+constexpr double C1 = (0.01 * 255) * (0.01 * 255);
+constexpr double C2 = (0.03 * 255) * (0.03 * 255);
+
+struct SSIMParams {
+    int window = WINDOW_SIZE;   // сторона квадратного окна, не меньше 2
+    int stride = WINDOW_SIZE;   // шаг окна; 1 — все положения окна
+};
+
+// Все окна 7x7 с шагом 1 и выборочной ковариацией: так считают эталонные
+// реализации без гауссовых весов (skimage structural_similarity по умолчанию)
+constexpr SSIMParams REFERENCE_SSIM{7, 1};
+
+// Таблицы сумм по прямоугольникам (summed-area tables) для x, y, x², y², xy
+// пары каналов: после одного прохода сумма любого окна — четыре обращения,
+// поэтому SSIM стоит O(1) на окно при любых размере окна и шаге
+class IntegralImages {
+public:
+    IntegralImages(const unsigned char* img1, const unsigned char* img2, int width, int height);
+
+    // Суммы по прямоугольнику [x, x + w) × [y, y + h)
+    simd::WindowSums window(int x, int y, int w, int h) const;
+
+private:
+    int stride;                             // width + 1
+    std::vector<simd::WindowSums> table;    // (height + 1) строк по stride; нулевые строка и столбец
+};
+
+double window_ssim(const simd::WindowSums& sums, int pixels);
+
+// Точная сумма квадратов разностей n байт (AVX-512BW, AVX2 или скалярно — по процессору)
+uint64_t channel_squared_error(const unsigned char* a, const unsigned char* b, size_t n);
 
 double image_mse(const Image& original, const Image& distorted);
 double image_psnr(const Image& original, const Image& distorted);
 double image_nc(const WM& original_wm, const WM& extracted_wm);
 double image_ber(const WM& original_wm, const WM& extracted_wm);
-double image_ssim(const Image& original, const Image& distorted);
-constexpr int WINDOW_SIZE = 8; // Фиксированный размер окна 8x8
-constexpr double C1 = (0.01 * 255) * (0.01 * 255);
-constexpr double C2 = (0.03 * 255) * (0.03 * 255);
+// То же для упакованных ЦВЗ: XOR и AND слов и popcount. Для слоёв из 0 и 255
+// совпадает с байтовыми image_nc и image_ber
+double image_nc(const PackedWM& original_wm, const PackedWM& extracted_wm);
+double image_ber(const PackedWM& original_wm, const PackedWM& extracted_wm);
+// NC для битов как ±1: Σ a·b / n = 1 - 2·BER, по одному popcount(a ^ b)
+double image_nc_bipolar(const PackedWM& original_wm, const PackedWM& extracted_wm);
+// Среднее SSIM окон params.window с шагом params.stride по каналам; по умолчанию —
+// окна 8x8 без перекрытия, для отчётов — REFERENCE_SSIM
+double image_ssim(const Image& original, const Image& distorted, const SSIMParams& params = {});
+
+// Гауссово SSIM (Wang et al., 2004): окно 11x11 с σ = 1.5 во всех положениях
+// без выхода за край, моменты по весам окна. MS-SSIM (Wang et al., 2003):
+// contrast-structure на каждом масштабе и полное SSIM на последнем, масштабы
+// получаются усреднением 2x2 предыдущего
+constexpr int GAUSSIAN_WINDOW = 11;
+constexpr double GAUSSIAN_SIGMA = 1.5;
+constexpr int MS_SSIM_SCALES = 5;
+
+double image_gaussian_ssim(const Image& original, const Image& distorted);
+double image_ms_ssim(const Image& original, const Image& distorted);
+
+// Эталон для многократных гауссовых SSIM и MS-SSIM: каналы переводятся во float
+// и уменьшаются один раз, для искажённого изображения каждый следующий масштаб
+// строится из предыдущего. Свёртка сепарабельная (строки, затем столбцы) и идёт
+// вертикальными полосами, чтобы кольцевой буфер отфильтрованных строк оставался
+// в кэше.
+class SSIMReference {
+public:
+    SSIMReference() = default;
+    // scales — сколько масштабов держать; меньше MS_SSIM_SCALES их будет и для
+    // изображений, у которых масштаб становится меньше окна
+    explicit SSIMReference(const Image& original, int scales = MS_SSIM_SCALES);
+
+    double gaussian_ssim(const Image& distorted) const;
+    // Веса масштабов из статьи; если масштабов меньше пяти, веса первых
+    // нормируются на их сумму. Отрицательные cs и SSIM обнуляются.
+    double ms_ssim(const Image& distorted) const;
+
+    struct Plane {
+        int width = 0, height = 0;
+        std::vector<float> data;
+    };
+
+private:
+    std::vector<Plane> pyramid[3];
+};
+
+struct ImageQuality {
+    double mse = 0.0;   // среднее по каналам
+    double psnr = 0.0;
+    double ssim = 0.0;  // окна 8x8 без перекрытия, среднее по каналам
+};
+
+// MSE, PSNR и SSIM за один проход по каждому каналу: изображения читаются
+// полосами по WINDOW_SIZE строк, и для каждого окна сразу накапливаются
+// суммы x, y, x², y², xy. Квадрат ошибки окна равен x² + y² - 2xy,
+// поэтому MSE не требует отдельного обхода.
+ImageQuality image_quality(const Image& original, const Image& distorted);
+
+struct RGBQuality {
+    ImageQuality channels[3];   // r, g, b
+    ImageQuality average;       // как у image_quality
+};
+
+// image_quality по чередующимся байтам RGB без слоёв r_lay/g_lay/b_lay: полоса
+// из WINDOW_SIZE строк разбирается на каналы в регистрах (pshufb) во временный
+// буфер размером в полосу и сразу обрабатывается. Результат побитово равен
+// image_quality. stride — байт на строку, не меньше 3·width. В отличие от
+// image_quality каналы считаются в одном потоке.
+RGBQuality interleaved_quality(const unsigned char* original, const unsigned char* distorted,
+                               int width, int height, size_t stride);
+// По image_vec (channels == 3)
+RGBQuality interleaved_quality(const Image& original, const Image& distorted);
+
+// image_quality для серии искажённых изображений, каждое из которых отличается
+// от предыдущего только в известных блоках 4x4 (номера — как в
+// *_blocks_coordinates: by · (width / 4) + bx). Хранятся суммы x, y, x², y², xy
+// каждого блока и SSIM каждого окна 8x8 (четыре блока): update() перечитывает
+// только задетые блоки и пересчитывает их окна по суммам, quality() — O(1).
+class QualityAccumulator {
+public:
+    QualityAccumulator(const Image& original, const Image& distorted);
+
+    // distorted отличается от предыдущего только в перечисленных блоках своих каналов
+    void update(const Image& distorted, const std::vector<uint16_t>& r_blocks,
+                const std::vector<uint16_t>& g_blocks, const std::vector<uint16_t>& b_blocks);
+    // Полный пересчёт, если изменённые блоки неизвестны
+    void reset(const Image& distorted);
+
+    // MSE точно равно image_quality; SSIM — с точностью до порядка суммирования
+    ImageQuality quality() const;
+
+private:
+    struct Channel {
+        std::vector<unsigned char> original;
+        std::vector<simd::WindowSums> blocks;  // суммы блоков 4x4
+        std::vector<double> window_ssim;       // SSIM окон 8x8
+        std::vector<uint8_t> dirty;            // окно задето текущим update()
+        std::vector<size_t> dirty_windows;     // их номера, без повторов
+        int64_t squared_error = 0;
+        double ssim_sum = 0.0;
+        size_t drift = 0;                      // окон обновлено после полного суммирования
+    };
+
+    double combined_ssim(const Channel& channel, size_t window) const;
+    void rebuild(Channel& channel, const std::vector<unsigned char>& distorted) const;
+    void update_channel(Channel& channel, const std::vector<unsigned char>& distorted,
+                        const std::vector<uint16_t>& blocks) const;
+    void check_size(const Image& distorted) const;
+
+    int width = 0, height = 0;
+    int blocks_x = 0, blocks_y = 0;
+    int windows_x = 0, windows_y = 0;
+    Channel channels[3];
+};
+
+struct WMComparison {
+    double nc = 0.0;    // среднее по каналам, как image_nc
+    double ber = 0.0;   // среднее по каналам, как image_ber
+};
+
+// Эталонный ЦВЗ для многократных сравнений: слои копируются и их нормы
+// считаются один раз. compare() за один проход по каждому слою даёт
+// и NC, и BER извлечённого ЦВЗ.
+class WMReference {
+public:
+    WMReference() = default;
+    explicit WMReference(const WM& original);
+
+    WMComparison compare(const WM& extracted) const;
+
+private:
+    std::vector<unsigned char> layers[3];
+    int64_t norm_sq[3] = {0, 0, 0};
+};
 
 #endif // METRICS_HPP
\ No newline at end of file
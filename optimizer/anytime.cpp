@@ -0,0 +1,181 @@
+#include "anytime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Пробные кандидаты берутся из отдельного «поколения», чтобы не совпасть
+// с начальной популяцией TLBO
+constexpr uint64_t PROBE_GENERATION = ~uint64_t(0);
+
+double seconds_since(CancelToken::Clock::time_point start) {
+    return std::chrono::duration<double>(CancelToken::Clock::now() - start).count();
+}
+
+// Сколько уровней пирамиды допускают самые маленькие изображения
+int feasible_levels(const std::vector<PFM>& packs, int wanted) {
+    int levels = wanted;
+    for (const PFM& pack : packs) {
+        int w = pack.src_image.width;
+        int h = pack.src_image.height;
+        int level = 0;
+        while (level < levels && w / 2 >= 4 && h / 2 >= 4) {
+            w = (w / 2) / 4 * 4;
+            h = (h / 2) / 4 * 4;
+            ++level;
+        }
+        levels = level;
+    }
+    return levels;
+}
+
+// Восстанавливает прежний токен Optimizer при любом выходе из run()
+struct CancelScope {
+    Optimizer& optimizer;
+    const CancelToken* previous;
+
+    CancelScope(Optimizer& optimizer, const CancelToken* token) : optimizer(optimizer), previous(optimizer.cancel) {
+        optimizer.cancel = token;
+    }
+    ~CancelScope() { optimizer.cancel = previous; }
+};
+
+} // namespace
+
+AnytimeTLBO::AnytimeTLBO(Optimizer& optimizer, const AnytimeParams& params)
+    : optimizer(optimizer), params(params) {
+    if (params.tlbo.lower.size() != params.tlbo.upper.size() || params.tlbo.lower.empty()) {
+        throw std::invalid_argument("AnytimeTLBO: bounds must be non-empty and of equal size");
+    }
+    if (params.min_population < 2 || params.max_population < params.min_population) {
+        throw std::invalid_argument("AnytimeTLBO: invalid population range");
+    }
+    if (params.budget.count() <= 0) {
+        throw std::invalid_argument("AnytimeTLBO: time budget must be positive");
+    }
+}
+
+// Полная оценка стоит 1, на подвыборке — fraction, на уровне пирамиды L — 4^-L.
+// Сначала подбирается популяция, затем при нехватке времени уменьшается
+// доля подвыборки, и в последнюю очередь включается грубый отбор.
+TLBOParams AnytimeTLBO::plan(double seconds_per_evaluation, double seconds_available) const {
+    TLBOParams tlbo = params.tlbo;
+    const double affordable = std::max(0.0, seconds_available) / std::max(seconds_per_evaluation, 1e-9);
+    const double generations = static_cast<double>(std::max<size_t>(1, params.target_generations));
+
+    const double population = std::clamp(affordable / (2.0 * generations),
+                                         static_cast<double>(params.min_population),
+                                         static_cast<double>(params.max_population));
+    tlbo.population_size = static_cast<size_t>(population);
+    const double p = static_cast<double>(tlbo.population_size);
+
+    tlbo.subsample_min_fraction = 1.0;
+    tlbo.fidelity_level = 0;
+    if (p * (1.0 + 2.0 * generations) <= affordable) return tlbo;
+
+    // На подвыборке каждое поколение ещё и переоценивает учеников
+    const double fraction = std::clamp(affordable / (p * (1.0 + 3.0 * generations)), params.min_fraction, 1.0);
+    if (fraction < 1.0) {
+        tlbo.subsample_min_fraction = fraction;
+        tlbo.subsample_final = params.finalists;
+    }
+    if (fraction > params.min_fraction) return tlbo;
+
+    const int level = feasible_levels(optimizer.packs, params.max_fidelity_level);
+    if (level > 0) {
+        tlbo.fidelity_level = level;
+        tlbo.fidelity_generations = params.target_generations;
+        tlbo.fidelity_promote = std::max<size_t>(1, tlbo.population_size / 4);
+    }
+    return tlbo;
+}
+
+AnytimeResult AnytimeTLBO::run() {
+    const CancelToken::Clock::time_point start = CancelToken::Clock::now();
+    const CancelToken::Clock::time_point hard_deadline = start + params.budget;
+
+    // До замера действует только жёсткий срок: без пробной партии нечего вернуть
+    token.reset();
+    token.setDeadline(hard_deadline);
+    CancelScope scope(optimizer, &token);
+    optimizer.updateFingerprint();
+
+    // Пробная партия: по кандидату на поток, чтобы замерить пропускную способность
+    const size_t dimensions = params.tlbo.lower.size();
+    const size_t probe_size = std::max(1u, std::thread::hardware_concurrency());
+    CounterRNG rng(params.tlbo.seed);
+    std::vector<Candidate> probe(probe_size, Candidate(dimensions));
+    for (size_t i = 0; i < probe_size; ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double r = rng.uniform(PROBE_GENERATION, i, d, STREAM_INIT);
+            probe[i][d] = params.tlbo.lower[d] + r * (params.tlbo.upper[d] - params.tlbo.lower[d]);
+        }
+    }
+    // Замер только самих оценок: отпечаток и эталоны ЦВЗ в него не входят
+    const CancelToken::Clock::time_point probe_start = CancelToken::Clock::now();
+    const std::vector<double> probe_fitness = optimizer.evaluatePopulation(probe);
+
+    AnytimeResult result;
+    AnytimeReport& report = result.report;
+    report.seconds_per_evaluation = seconds_since(probe_start) / probe_size;
+
+    // Запасной ответ на случай, если TLBO не успеет ничего оценить
+    result.best = probe[0];
+    result.best_fitness = std::numeric_limits<double>::quiet_NaN();
+    for (size_t i = 0; i < probe_size; ++i) {
+        if (std::isnan(probe_fitness[i])) continue;
+        if (std::isnan(result.best_fitness) || probe_fitness[i] > result.best_fitness) {
+            result.best = probe[i];
+            result.best_fitness = probe_fitness[i];
+            report.exact = true;
+        }
+    }
+
+    // Резерв на итоговую оценку — не меньше времени на finalists кандидатов с запасом
+    const double reserve = std::max(params.final_reserve * std::chrono::duration<double>(params.budget).count(),
+                                    1.5 * report.seconds_per_evaluation * params.finalists);
+    const CancelToken::Clock::time_point soft_deadline = hard_deadline -
+        std::chrono::duration_cast<CancelToken::Clock::duration>(std::chrono::duration<double>(reserve));
+    token.setDeadline(soft_deadline);
+
+    if (!optimizer.cancelled()) {
+        const double available = std::chrono::duration<double>(soft_deadline - CancelToken::Clock::now()).count();
+        const TLBOParams planned = plan(report.seconds_per_evaluation, available);
+
+        TLBO tlbo(optimizer, planned);
+        tlbo.initialize();
+        while (!tlbo.finished() && !optimizer.cancelled()) {
+            tlbo.step();
+        }
+        report.deadline_hit = optimizer.cancelled();
+        report.subsample_fraction = tlbo.getSubsampleFraction();
+        report.diversity = tlbo.diversity();
+        report.stall = tlbo.getStall();
+
+        // Итоговая оценка идёт в резерве до жёсткого срока
+        token.reset();
+        token.setDeadline(hard_deadline);
+        const TLBOResult final_result = tlbo.finish();
+
+        if (!std::isnan(final_result.best_fitness) &&
+            (std::isnan(result.best_fitness) || final_result.best_fitness > result.best_fitness)) {
+            result.best = final_result.best;
+            result.best_fitness = final_result.best_fitness;
+            report.exact = final_result.exact;
+        }
+
+        report.population_size = planned.population_size;
+        report.fidelity_level = planned.fidelity_level;
+        report.generations = final_result.generations;
+        report.evaluations = final_result.evaluations;
+    } else {
+        report.deadline_hit = true;
+    }
+
+    report.evaluations += probe_size;
+    report.elapsed = seconds_since(start);
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef ANYTIME_HPP
+#define ANYTIME_HPP
+
+#include <chrono>
+#include <cstddef>
+#include "tlbo.hpp"
+#include "cancel_token.hpp"
+
+struct AnytimeParams {
+    std::chrono::milliseconds budget{60000};  // весь запуск, включая итоговую оценку
+    TLBOParams tlbo;                  // границы, seed, racing; размер популяции и точность подбираются
+    size_t min_population = 6;
+    size_t max_population = 50;
+    size_t target_generations = 30;   // поколений, на которые рассчитывается план
+    double min_fraction = 0.25;       // нижняя граница доли подвыборки
+    int max_fidelity_level = 2;       // самый грубый уровень пирамиды для отбора; 0 — без пирамиды
+    size_t finalists = 3;             // кандидатов на итоговую полную оценку
+    double final_reserve = 0.1;       // доля бюджета на итоговую оценку (не меньше полутора оценок на финалиста)
+};
+
+// Отчёт о том, насколько можно доверять результату
+struct AnytimeReport {
+    bool deadline_hit = false;        // остановлено по времени, а не по сходимости или лимитам
+    bool exact = false;               // best_fitness получено на полном наборе пачек и атак
+    double elapsed = 0.0;             // секунд от начала run()
+    double seconds_per_evaluation = 0.0;   // измеренная пропускная способность
+    size_t population_size = 0;       // выбранные планом параметры
+    double subsample_fraction = 1.0;  // доля данных в последнем поколении
+    int fidelity_level = 0;
+    size_t generations = 0;
+    size_t evaluations = 0;
+    double diversity = 0.0;           // разброс популяции при остановке: 0 — сошлась
+    size_t stall = 0;                 // поколений без улучшения при остановке
+};
+
+struct AnytimeResult {
+    Candidate best;
+    double best_fitness = 0.0;
+    AnytimeReport report;
+};
+
+// TLBO с ограничением по времени. Сначала замеряется стоимость оценки на
+// пробной партии кандидатов; по ней выбираются размер популяции, доля
+// подвыборки и грубый уровень отбора так, чтобы в бюджет поместилось
+// target_generations поколений. К сроку (за вычетом резерва на итоговую
+// оценку) текущие оценки прерываются через CancelToken, и возвращается
+// лучшее найденное решение с отчётом.
+class AnytimeTLBO {
+public:
+    AnytimeTLBO(Optimizer& optimizer, const AnytimeParams& params);
+
+    AnytimeResult run();
+
+private:
+    Optimizer& optimizer;
+    AnytimeParams params;
+    CancelToken token;
+
+    TLBOParams plan(double seconds_per_evaluation, double seconds_available) const;
+};
+
+#endif // ANYTIME_HPP
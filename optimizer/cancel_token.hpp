@@ -0,0 +1,37 @@
+#ifndef CANCEL_TOKEN_HPP
+#define CANCEL_TOKEN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+// Кооперативная отмена: оценки проверяют токен между стадиями конвейера
+// и бросают незавершённую работу. Срабатывает по явному cancel() или
+// по наступлению срока.
+class CancelToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void cancel() { flag.store(true, std::memory_order_relaxed); }
+
+    void setDeadline(Clock::time_point deadline) {
+        deadline_ticks.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void reset() {
+        flag.store(false, std::memory_order_relaxed);
+        deadline_ticks.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    }
+
+    bool cancelled() const {
+        if (flag.load(std::memory_order_relaxed)) return true;
+        return Clock::now().time_since_epoch().count() >= deadline_ticks.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> flag{false};
+    std::atomic<int64_t> deadline_ticks{std::numeric_limits<int64_t>::max()};
+};
+
+#endif // CANCEL_TOKEN_HPP
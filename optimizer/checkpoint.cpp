@@ -0,0 +1,274 @@
+#include "checkpoint.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t dimensions;
+    uint64_t population_size;
+    uint64_t generation;
+    uint64_t evaluations;
+    uint64_t abandoned;
+    uint64_t stall;
+    double best_so_far;
+    uint64_t dataset_fingerprint;
+    double subsample_fraction;
+    uint64_t rng_seed;
+    uint64_t cache_records;
+    uint64_t payload_bytes;
+    uint64_t payload_hash;    // FNV-1a всего, что следует за заголовком
+};
+
+static void append(std::vector<unsigned char>& out, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    out.insert(out.end(), p, p + bytes);
+}
+
+static void write_all(int fd, const unsigned char* data, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t n = write(fd, data, bytes);
+        if (n < 0) throw std::runtime_error("Checkpoint: write failed");
+        data += n;
+        bytes -= static_cast<size_t>(n);
+    }
+}
+
+// rename() надёжен только после fsync каталога, где лежит запись о файле
+static void sync_parent_directory(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        throw std::runtime_error("Checkpoint: cannot open directory " + dir);
+    }
+    const int status = fsync(fd);
+    close(fd);
+    if (status != 0) throw std::runtime_error("Checkpoint: fsync failed for directory " + dir);
+}
+
+// Размеры из заголовка сверяются с payload делением, чтобы
+// поддельные dimensions/population_size не переполнили произведение
+static bool payload_fits(const CheckpointHeader& header, size_t payload_bytes) {
+    const size_t words = payload_bytes / sizeof(double);
+    const size_t dims = header.dimensions;
+    const size_t pop = header.population_size;
+    if (dims == 0 || dims >= words || pop > words / (dims + 1)) return false;
+
+    const size_t population_bytes = pop * (dims + 1) * sizeof(double);
+    const size_t record_words = dims + 2;
+    const size_t rest_words = (payload_bytes - population_bytes) / sizeof(double);
+    if (header.cache_records > rest_words / record_words) return false;
+    return population_bytes + header.cache_records * record_words * sizeof(double) == payload_bytes;
+}
+
+void saveCheckpoint(const std::string& path, const TLBOState& state) {
+    const size_t dims = state.dimensions;
+    if (dims == 0 || state.population.size() != state.fitness.size() * dims) {
+        throw std::invalid_argument("Checkpoint: inconsistent state");
+    }
+
+    std::vector<unsigned char> payload;
+    payload.reserve((state.population.size() + state.fitness.size() + state.cache.size() * (dims + 2)) * 8);
+    append(payload, state.population.data(), state.population.size() * sizeof(double));
+    append(payload, state.fitness.data(), state.fitness.size() * sizeof(double));
+
+    uint64_t cache_records = 0;
+    for (const FitnessCache::Record& record : state.cache) {
+        if (record.key.quantized.size() != dims) continue;
+        append(payload, &record.key.dataset, sizeof(uint64_t));
+        append(payload, record.key.quantized.data(), dims * sizeof(int64_t));
+        append(payload, &record.fitness, sizeof(double));
+        ++cache_records;
+    }
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.dimensions = dims;
+    header.population_size = state.fitness.size();
+    header.generation = state.generation;
+    header.evaluations = state.evaluations;
+    header.abandoned = state.abandoned;
+    header.stall = state.stall;
+    header.best_so_far = state.best_so_far;
+    header.dataset_fingerprint = state.dataset_fingerprint;
+    header.subsample_fraction = state.subsample_fraction;
+    header.rng_seed = state.rng_seed;
+    header.cache_records = cache_records;
+    header.payload_bytes = payload.size();
+    header.payload_hash = fnv1a(payload.data(), payload.size());
+
+    // Временный файл + rename: при сбое на диске остаётся предыдущая целая точка
+    const std::string tmp_path = path + ".tmp";
+    const int fd = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Checkpoint: cannot create " + tmp_path);
+    }
+    try {
+        write_all(fd, reinterpret_cast<const unsigned char*>(&header), sizeof(header));
+        write_all(fd, payload.data(), payload.size());
+        if (fsync(fd) != 0) throw std::runtime_error("Checkpoint: fsync failed");
+    } catch (...) {
+        close(fd);
+        unlink(tmp_path.c_str());
+        throw;
+    }
+    close(fd);
+
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        throw std::runtime_error("Checkpoint: cannot rename to " + path);
+    }
+    sync_parent_directory(path);
+}
+
+bool checkpointExists(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+TLBOState loadCheckpoint(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Checkpoint: cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CheckpointHeader)) {
+        close(fd);
+        throw std::runtime_error("Checkpoint: file is truncated: " + path);
+    }
+    const size_t file_bytes = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Checkpoint: mmap failed for " + path);
+    }
+
+    const unsigned char* data = static_cast<const unsigned char*>(mapped);
+    CheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const unsigned char* payload = data + sizeof(header);
+
+    const char* error = nullptr;
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        error = "bad magic";
+    } else if (header.version != CHECKPOINT_VERSION) {
+        error = "unsupported version";
+    } else if (header.payload_bytes != file_bytes - sizeof(header) || !payload_fits(header, header.payload_bytes)) {
+        error = "size mismatch";
+    } else if (fnv1a(payload, header.payload_bytes) != header.payload_hash) {
+        error = "checksum mismatch";
+    }
+    if (error != nullptr) {
+        munmap(mapped, file_bytes);
+        throw std::runtime_error(std::string("Checkpoint: ") + error + ": " + path);
+    }
+
+    const size_t dims = header.dimensions;
+    const size_t pop = header.population_size;
+
+    TLBOState state;
+    state.dimensions = dims;
+    state.generation = header.generation;
+    state.evaluations = header.evaluations;
+    state.abandoned = header.abandoned;
+    state.stall = header.stall;
+    state.best_so_far = header.best_so_far;
+    state.dataset_fingerprint = header.dataset_fingerprint;
+    state.subsample_fraction = header.subsample_fraction;
+    state.rng_seed = header.rng_seed;
+
+    const unsigned char* p = payload;
+    state.population.resize(pop * dims);
+    std::memcpy(state.population.data(), p, pop * dims * sizeof(double));
+    p += pop * dims * sizeof(double);
+    state.fitness.resize(pop);
+    std::memcpy(state.fitness.data(), p, pop * sizeof(double));
+    p += pop * sizeof(double);
+
+    state.cache.resize(header.cache_records);
+    for (FitnessCache::Record& record : state.cache) {
+        std::memcpy(&record.key.dataset, p, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+        record.key.quantized.resize(dims);
+        std::memcpy(record.key.quantized.data(), p, dims * sizeof(int64_t));
+        p += dims * sizeof(int64_t);
+        std::memcpy(&record.fitness, p, sizeof(double));
+        p += sizeof(double);
+    }
+
+    munmap(mapped, file_bytes);
+    return state;
+}
+
+CheckpointWriter::CheckpointWriter(std::string path)
+    : path(std::move(path)), worker(&CheckpointWriter::loop, this) {}
+
+CheckpointWriter::~CheckpointWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void CheckpointWriter::submit(TLBOState state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(state);
+    }
+    wake.notify_one();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !pending && !busy; });
+}
+
+size_t CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written_count;
+}
+
+std::string CheckpointWriter::lastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void CheckpointWriter::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending.has_value() || stopping; });
+        if (!pending) break;
+
+        TLBOState state = std::move(*pending);
+        pending.reset();
+        busy = true;
+        lock.unlock();
+
+        // Ошибка записи не должна останавливать оптимизацию — она запоминается
+        std::string failure;
+        try {
+            saveCheckpoint(path, state);
+        } catch (const std::exception& e) {
+            failure = e.what();
+        }
+
+        lock.lock();
+        busy = false;
+        if (failure.empty()) {
+            ++written_count;
+        } else {
+            error = failure;
+        }
+        idle.notify_all();
+    }
+}
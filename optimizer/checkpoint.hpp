@@ -0,0 +1,72 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <cstdint>
+#include "fitness_cache.hpp"
+
+// Снимок состояния TLBO, достаточный для продолжения прерванного запуска
+struct TLBOState {
+    uint64_t dimensions = 0;
+    uint64_t generation = 0;
+    uint64_t evaluations = 0;
+    uint64_t abandoned = 0;
+    uint64_t stall = 0;
+    double best_so_far = 0.0;
+    uint64_t dataset_fingerprint = 0;      // Optimizer::dataset_fingerprint, на котором получены fitness
+    double subsample_fraction = 1.0;       // доля подвыборки в момент снимка
+    std::vector<double> population;        // population_size × dimensions, построчно
+    std::vector<double> fitness;
+    uint64_t rng_seed = 0;                 // ключ Philox; остальное состояние — номер поколения
+    std::vector<FitnessCache::Record> cache;  // записи кэша, от последних использованных
+};
+
+// Формат файла (little-endian):
+//   CheckpointHeader | population | fitness | cache records
+// Запись идёт во временный файл, который затем атомарно переименовывается.
+constexpr char CHECKPOINT_MAGIC[8] = {'H', 'T', 'X', 'T', 'L', 'B', 'O', 0};
+constexpr uint32_t CHECKPOINT_VERSION = 3;
+
+void saveCheckpoint(const std::string& path, const TLBOState& state);
+TLBOState loadCheckpoint(const std::string& path);  // чтение через mmap
+bool checkpointExists(const std::string& path);
+
+// Фоновая запись контрольных точек: submit() только перемещает снимок в очередь
+// и сразу возвращается; если предыдущая запись ещё идёт, ожидающий снимок
+// заменяется более свежим
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::string path);
+    ~CheckpointWriter();
+
+    void submit(TLBOState state);
+    void flush();                          // дождаться записи всех отправленных снимков
+
+    size_t written() const;
+    std::string lastError() const;
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+private:
+    std::string path;
+    std::optional<TLBOState> pending;
+    bool busy = false;
+    bool stopping = false;
+    size_t written_count = 0;
+    std::string error;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::thread worker;
+
+    void loop();
+};
+
+#endif // CHECKPOINT_HPP
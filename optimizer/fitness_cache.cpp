@@ -0,0 +1,114 @@
+#include "fitness_cache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+uint64_t fnv1a(const void* data, size_t bytes, uint64_t hash) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+size_t FitnessKeyHash::operator()(const FitnessKey& key) const {
+    uint64_t hash = fnv1a(&key.dataset, sizeof(key.dataset));
+    return fnv1a(key.quantized.data(), key.quantized.size() * sizeof(int64_t), hash);
+}
+
+FitnessCache::FitnessCache(size_t capacity, double quantum)
+    : max_entries(capacity), quantum(quantum) {
+    if (capacity == 0) {
+        throw std::invalid_argument("FitnessCache: capacity must be positive");
+    }
+    if (!(quantum > 0.0)) {
+        throw std::invalid_argument("FitnessCache: quantum must be positive");
+    }
+}
+
+// Близкие векторы (в пределах шага квантования) получают один и тот же ключ.
+// Частное ограничивается до ±2^62, иначе llround не определён; такие
+// огромные значения сливаются в один ключ на краю диапазона.
+bool FitnessCache::makeKey(const std::vector<double>& candidate, uint64_t dataset, FitnessKey& key) const {
+    constexpr double LIMIT = 4611686018427387904.0;  // 2^62
+    key.dataset = dataset;
+    key.quantized.resize(candidate.size());
+    for (size_t d = 0; d < candidate.size(); ++d) {
+        if (!std::isfinite(candidate[d])) return false;
+        const double q = std::clamp(candidate[d] / quantum, -LIMIT, LIMIT);
+        key.quantized[d] = static_cast<int64_t>(std::llround(q));
+    }
+    return true;
+}
+
+bool FitnessCache::lookup(const FitnessKey& key, double& fitness) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        ++miss_count;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    fitness = it->second->fitness;
+    ++hit_count;
+    return true;
+}
+
+void FitnessCache::insert(const FitnessKey& key, double fitness) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->fitness = fitness;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    if (entries.size() >= max_entries) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    entries.push_front({key, fitness});
+    index.emplace(key, entries.begin());
+}
+
+void FitnessCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    hit_count = 0;
+    miss_count = 0;
+}
+
+std::vector<FitnessCache::Record> FitnessCache::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<Record>(entries.begin(), entries.end());
+}
+
+void FitnessCache::restore(const std::vector<Record>& records) {
+    // Вставка с конца сохраняет порядок LRU исходного кэша
+    for (auto it = records.rbegin(); it != records.rend(); ++it) {
+        insert(it->key, it->fitness);
+    }
+}
+
+size_t FitnessCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t FitnessCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hit_count;
+}
+
+size_t FitnessCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return miss_count;
+}
+
+double FitnessCache::hitRate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t total = hit_count + miss_count;
+    return (total > 0) ? static_cast<double>(hit_count) / total : 0.0;
+}
@@ -0,0 +1,66 @@
+#ifndef FITNESS_CACHE_HPP
+#define FITNESS_CACHE_HPP
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Ключ кэша: квантованный вектор параметров + отпечаток набора данных
+struct FitnessKey {
+    uint64_t dataset = 0;
+    std::vector<int64_t> quantized;
+
+    bool operator==(const FitnessKey& other) const {
+        return dataset == other.dataset && quantized == other.quantized;
+    }
+};
+
+struct FitnessKeyHash {
+    size_t operator()(const FitnessKey& key) const;
+};
+
+// Потокобезопасный LRU-кэш значений целевой функции
+class FitnessCache {
+public:
+    explicit FitnessCache(size_t capacity = 4096, double quantum = 1e-6);
+
+    struct Record {
+        FitnessKey key;
+        double fitness;
+    };
+
+    // false для кандидатов с NaN/inf: их значения не кэшируются
+    bool makeKey(const std::vector<double>& candidate, uint64_t dataset, FitnessKey& key) const;
+
+    bool lookup(const FitnessKey& key, double& fitness);
+    void insert(const FitnessKey& key, double fitness);
+    void clear();
+
+    // Содержимое от последних использованных к давним и обратная загрузка
+    std::vector<Record> snapshot() const;
+    void restore(const std::vector<Record>& records);
+
+    size_t size() const;
+    size_t capacity() const { return max_entries; }
+    size_t hits() const;
+    size_t misses() const;
+    double hitRate() const;
+
+private:
+    size_t max_entries;
+    double quantum;
+
+    std::list<Record> entries;  // начало списка — последние использованные
+    std::unordered_map<FitnessKey, std::list<Record>::iterator, FitnessKeyHash> index;
+    size_t hit_count = 0;
+    size_t miss_count = 0;
+    mutable std::mutex mutex;
+};
+
+// FNV-1a, используется для отпечатков данных и ключей кэша
+uint64_t fnv1a(const void* data, size_t bytes, uint64_t hash = 0xcbf29ce484222325ULL);
+
+#endif // FITNESS_CACHE_HPP
@@ -0,0 +1,260 @@
+#include "island.hpp"
+#include "executor/executor.hpp"
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <new>
+#include <cstring>
+#include <stdexcept>
+#include <omp.h>
+#include <sched.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring requires lock-free 64-bit atomics");
+
+constexpr size_t SHM_ALIGN = 64;  // отдельная кэш-линия под каждый счётчик
+
+enum IslandStatus : uint64_t { ISLAND_RUNNING = 0, ISLAND_DONE = 1, ISLAND_FAILED = 2 };
+
+// Кольцо с одним писателем (предыдущий остров) и одним читателем (владелец)
+struct RingHeader {
+    alignas(SHM_ALIGN) std::atomic<uint64_t> head;  // сколько записано
+    alignas(SHM_ALIGN) std::atomic<uint64_t> tail;  // сколько прочитано
+};
+
+struct IslandReport {
+    std::atomic<uint64_t> status;
+    uint64_t evaluations;
+    uint64_t migrations;
+    uint64_t exact;
+    double best_fitness;
+};
+
+static size_t align_up(size_t bytes) {
+    return (bytes + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN;
+}
+
+// Размещение данных в сегменте: для каждого острова — заголовок кольца,
+// слоты мигрантов (fitness + вектор) и отчёт с лучшим решением
+struct SharedLayout {
+    unsigned char* base;
+    size_t dims;
+    size_t capacity;
+
+    size_t slotBytes() const { return (dims + 1) * sizeof(double); }
+    size_t reportBytes() const { return align_up(sizeof(IslandReport) + dims * sizeof(double)); }
+    size_t islandBytes() const {
+        return align_up(sizeof(RingHeader)) + align_up(capacity * slotBytes()) + reportBytes();
+    }
+
+    unsigned char* island(size_t k) const { return base + k * islandBytes(); }
+    RingHeader* ring(size_t k) const { return reinterpret_cast<RingHeader*>(island(k)); }
+    double* slot(size_t k, uint64_t n) const {
+        unsigned char* slots = island(k) + align_up(sizeof(RingHeader));
+        return reinterpret_cast<double*>(slots + (n % capacity) * slotBytes());
+    }
+    IslandReport* report(size_t k) const {
+        return reinterpret_cast<IslandReport*>(island(k) + align_up(sizeof(RingHeader)) + align_up(capacity * slotBytes()));
+    }
+    double* reportVector(size_t k) const { return reinterpret_cast<double*>(report(k) + 1); }
+};
+
+// Отправка без ожидания: при заполненном кольце мигрант отбрасывается
+static bool ring_push(const SharedLayout& layout, size_t k, const Candidate& candidate, double fitness) {
+    RingHeader* ring = layout.ring(k);
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head - tail >= layout.capacity) return false;
+
+    double* slot = layout.slot(k, head);
+    slot[0] = fitness;
+    std::memcpy(slot + 1, candidate.data(), layout.dims * sizeof(double));
+    ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+static bool ring_pop(const SharedLayout& layout, size_t k, Candidate& candidate, double& fitness) {
+    RingHeader* ring = layout.ring(k);
+    const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    if (tail == head) return false;
+
+    const double* slot = layout.slot(k, tail);
+    fitness = slot[0];
+    candidate.assign(slot + 1, slot + 1 + layout.dims);
+    ring->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+// Доля ядер острова: непрерывный диапазон из маски координатора,
+// соседние номера CPU обычно принадлежат одному узлу NUMA
+static void pin_to_share(size_t island, size_t islands) {
+    cpu_set_t available;
+    if (sched_getaffinity(0, sizeof(available), &available) != 0) return;
+
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &available)) cpus.push_back(cpu);
+    }
+    if (cpus.size() < islands) return;
+
+    const size_t share = cpus.size() / islands;
+    cpu_set_t mine;
+    CPU_ZERO(&mine);
+    for (size_t c = island * share; c < (island + 1) * share; ++c) {
+        CPU_SET(cpus[c], &mine);
+    }
+    if (sched_setaffinity(0, sizeof(mine), &mine) == 0) {
+        omp_set_num_threads(static_cast<int>(share));
+        Executor::instance().setParallelism(share - 1);
+    }
+}
+
+IslandModel::IslandModel(Optimizer& optimizer, const IslandParams& params)
+    : optimizer(optimizer), params(params), dimensions(params.tlbo.lower.size()) {
+    if (params.islands == 0) {
+        throw std::invalid_argument("IslandModel: at least one island is required");
+    }
+    if (params.ring_capacity == 0 || params.migration_interval == 0) {
+        throw std::invalid_argument("IslandModel: ring capacity and migration interval must be positive");
+    }
+    if (params.migrants > params.tlbo.population_size) {
+        throw std::invalid_argument("IslandModel: more migrants than learners on an island");
+    }
+}
+
+void IslandModel::runWorker(void* shared, size_t island) const {
+    const SharedLayout layout{static_cast<unsigned char*>(shared), dimensions, params.ring_capacity};
+    IslandReport* report = layout.report(island);
+    const size_t next = (island + 1) % params.islands;
+
+    TLBOParams island_params = params.tlbo;
+    island_params.seed += island;
+    TLBO tlbo(optimizer, island_params);
+    tlbo.initialize();
+
+    size_t accepted = 0;
+    while (!tlbo.finished()) {
+        tlbo.step();
+        if (params.islands < 2 || tlbo.getGeneration() % params.migration_interval != 0) continue;
+
+        const std::vector<double>& fitness = tlbo.getFitness();
+        std::vector<size_t> order(fitness.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + params.migrants, order.end(),
+                          [&](size_t a, size_t b) { return fitness[a] > fitness[b]; });
+        for (size_t m = 0; m < params.migrants; ++m) {
+            ring_push(layout, next, tlbo.getPopulation().row(order[m]), fitness[order[m]]);
+        }
+
+        Candidate migrant;
+        double migrant_fitness;
+        while (ring_pop(layout, island, migrant, migrant_fitness)) {
+            if (tlbo.immigrate(migrant, migrant_fitness)) ++accepted;
+        }
+    }
+
+    // finish() переоценивает лучших на полном наборе: координатор
+    // сравнивает острова только по точным значениям
+    const TLBOResult result = tlbo.finish();
+    report->evaluations = result.evaluations;
+    report->migrations = accepted;
+    report->exact = result.exact;
+    report->best_fitness = result.best_fitness;
+    std::memcpy(layout.reportVector(island), result.best.data(), dimensions * sizeof(double));
+    report->status.store(ISLAND_DONE, std::memory_order_release);
+}
+
+IslandResult IslandModel::run() {
+    const SharedLayout sizing{nullptr, dimensions, params.ring_capacity};
+    const size_t bytes = params.islands * sizing.islandBytes();
+
+    const std::string name = "/ht_x_tlbo_islands_" + std::to_string(getpid());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("IslandModel: shm_open failed for " + name);
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("IslandModel: ftruncate failed");
+    }
+    void* shared = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    // Отображение наследуется при fork, имя больше не нужно — сегмент не останется после сбоя
+    shm_unlink(name.c_str());
+    if (shared == MAP_FAILED) {
+        throw std::runtime_error("IslandModel: mmap failed");
+    }
+
+    const SharedLayout layout{static_cast<unsigned char*>(shared), dimensions, params.ring_capacity};
+    for (size_t k = 0; k < params.islands; ++k) {
+        RingHeader* ring = new (layout.ring(k)) RingHeader;
+        ring->head.store(0);
+        ring->tail.store(0);
+        IslandReport* report = new (layout.report(k)) IslandReport;
+        report->status.store(ISLAND_RUNNING);
+    }
+
+    optimizer.updateFingerprint();
+
+    std::vector<pid_t> workers;
+    for (size_t k = 0; k < params.islands; ++k) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            int code = 0;
+            try {
+                if (params.pin_workers) pin_to_share(k, params.islands);
+                runWorker(shared, k);
+            } catch (...) {
+                layout.report(k)->status.store(ISLAND_FAILED, std::memory_order_release);
+                code = 1;
+            }
+            _exit(code);
+        }
+        if (pid < 0) {
+            for (pid_t worker : workers) kill(worker, SIGKILL);
+            for (pid_t worker : workers) waitpid(worker, nullptr, 0);
+            munmap(shared, bytes);
+            throw std::runtime_error("IslandModel: fork failed");
+        }
+        workers.push_back(pid);
+    }
+
+    bool failed = false;
+    for (pid_t worker : workers) {
+        int status = 0;
+        if (waitpid(worker, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+        }
+    }
+
+    IslandResult result;
+    bool have_best = false;
+    for (size_t k = 0; k < params.islands && !failed; ++k) {
+        const IslandReport* report = layout.report(k);
+        if (report->status.load(std::memory_order_acquire) != ISLAND_DONE) {
+            failed = true;
+            break;
+        }
+        result.evaluations += report->evaluations;
+        result.migrations += report->migrations;
+        if (!have_best || report->best_fitness > result.best_fitness) {
+            have_best = true;
+            result.best_fitness = report->best_fitness;
+            result.exact = report->exact != 0;
+            result.best_island = k;
+            result.best.assign(layout.reportVector(k), layout.reportVector(k) + dimensions);
+        }
+    }
+
+    munmap(shared, bytes);
+    if (failed) {
+        throw std::runtime_error("IslandModel: worker process failed");
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef ISLAND_HPP
+#define ISLAND_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "tlbo.hpp"
+
+struct IslandParams {
+    size_t islands = 4;               // число рабочих процессов
+    size_t migration_interval = 5;    // поколений между миграциями
+    size_t migrants = 2;              // сколько лучших особей отправляется за раз
+    size_t ring_capacity = 16;        // вместимость входящего кольца острова
+    bool pin_workers = true;          // закрепить каждый процесс за своей долей ядер
+    TLBOParams tlbo;                  // параметры подпопуляции; seed острова k = seed + k
+};
+
+struct IslandResult {
+    Candidate best;
+    double best_fitness = 0.0;
+    size_t best_island = 0;
+    size_t evaluations = 0;           // сумма по всем островам
+    size_t migrations = 0;            // принятых мигрантов по всем островам
+    bool exact = true;                // best_fitness получено на полном наборе пачек и атак
+};
+
+// Островная модель TLBO: каждый остров — отдельный процесс (fork) со своей
+// подпопуляцией. Лучшие особи раз в migration_interval поколений уходят по
+// кольцу к соседу (k → k+1) через кольцевой буфер в разделяемой памяти POSIX.
+// При подвыборке мигранты переоцениваются на острове-получателе, а итог
+// каждого острова — на полном наборе (TLBO::finish).
+// Вызывающий процесс выступает координатором и не должен до run() запускать
+// параллельные области OpenMP: пул потоков не переживает fork.
+class IslandModel {
+public:
+    IslandModel(Optimizer& optimizer, const IslandParams& params);
+
+    IslandResult run();
+
+private:
+    Optimizer& optimizer;
+    IslandParams params;
+    size_t dimensions;
+
+    void runWorker(void* shared, size_t island) const;
+};
+
+#endif // ISLAND_HPP
@@ -0,0 +1,216 @@
+#include "mo_tlbo.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+ObjectivePoint to_point(const Objectives& objectives) {
+    return {objectives.imperceptibility, objectives.robustness};
+}
+
+MOTLBO::MOTLBO(Optimizer& optimizer, const MOTLBOParams& params)
+    : optimizer(optimizer), params(params), rng(params.tlbo.seed), dimensions(params.tlbo.lower.size()) {
+    if (params.tlbo.lower.size() != params.tlbo.upper.size() || params.tlbo.lower.empty()) {
+        throw std::invalid_argument("MOTLBO: bounds must be non-empty and of equal size");
+    }
+    if (params.tlbo.population_size < 2 || params.archive_size == 0) {
+        throw std::invalid_argument("MOTLBO: population size must be at least 2 and archive non-empty");
+    }
+}
+
+std::vector<Objectives> MOTLBO::evaluate(const Population& candidates) {
+    evaluations += candidates.size();
+    return optimizer.evaluateObjectives(candidates.rows());
+}
+
+// Архив хранит только фронт 0; при переполнении по одному удаляются
+// самые скученные решения
+void MOTLBO::updateArchive(const std::vector<ParetoSolution>& candidates) {
+    std::vector<ParetoSolution> merged = archive;
+    merged.insert(merged.end(), candidates.begin(), candidates.end());
+
+    std::vector<ObjectivePoint> points(merged.size());
+    for (size_t k = 0; k < merged.size(); ++k) {
+        points[k] = to_point(merged[k].objectives);
+    }
+    std::vector<size_t> front = nondominated_sort(points).front();
+
+    while (front.size() > params.archive_size) {
+        const std::vector<double> distance = crowding_distance(points, front);
+        const size_t worst = std::min_element(distance.begin(), distance.end()) - distance.begin();
+        front.erase(front.begin() + worst);
+    }
+
+    std::sort(front.begin(), front.end(), [&](size_t a, size_t b) { return points[a][0] > points[b][0]; });
+    archive.clear();
+    for (size_t k : front) {
+        archive.push_back(merged[k]);
+    }
+}
+
+size_t MOTLBO::pickTeacher() const {
+    std::vector<ObjectivePoint> points(archive.size());
+    for (size_t k = 0; k < archive.size(); ++k) {
+        points[k] = to_point(archive[k].objectives);
+    }
+    std::vector<size_t> all(archive.size());
+    std::iota(all.begin(), all.end(), 0);
+    const std::vector<double> distance = crowding_distance(points, all);
+    return std::max_element(distance.begin(), distance.end()) - distance.begin();
+}
+
+// Отбор P лучших из P текущих и P предложенных: по фронтам, последний
+// фронт — по убыванию расстояния скученности
+void MOTLBO::select(const std::vector<Objectives>& proposal_objectives) {
+    const size_t p = population.size();
+    std::vector<ObjectivePoint> points(2 * p);
+    for (size_t i = 0; i < p; ++i) {
+        points[i] = to_point(objectives[i]);
+        points[p + i] = to_point(proposal_objectives[i]);
+    }
+
+    const std::vector<std::vector<size_t>> fronts = nondominated_sort(points);
+    std::vector<size_t> chosen;
+    chosen.reserve(p);
+    for (const std::vector<size_t>& front : fronts) {
+        if (chosen.size() + front.size() <= p) {
+            chosen.insert(chosen.end(), front.begin(), front.end());
+            continue;
+        }
+        const std::vector<double> distance = crowding_distance(points, front);
+        std::vector<size_t> order(front.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return distance[a] > distance[b]; });
+        for (size_t k = 0; chosen.size() < p; ++k) {
+            chosen.push_back(front[order[k]]);
+        }
+        break;
+    }
+
+    std::vector<ParetoSolution> first_front;
+    for (size_t k : fronts.front()) {
+        if (k >= p) first_front.push_back({proposals.row(k - p), proposal_objectives[k - p]});
+    }
+
+    Population next(p, dimensions);
+    std::vector<Objectives> next_objectives(p);
+    for (size_t i = 0; i < p; ++i) {
+        const size_t k = chosen[i];
+        if (k < p) {
+            next.copyRow(i, population, k);
+            next_objectives[i] = objectives[k];
+        } else {
+            next.copyRow(i, proposals, k - p);
+            next_objectives[i] = proposal_objectives[k - p];
+        }
+    }
+    population = std::move(next);
+    objectives = std::move(next_objectives);
+
+    updateArchive(first_front);
+}
+
+void MOTLBO::initialize() {
+    const size_t p = params.tlbo.population_size;
+    population = Population(p, dimensions);
+    proposals = Population(p, dimensions);
+    random = Population(p, dimensions);
+    generation = 0;
+    evaluations = 0;
+    archive.clear();
+
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double r = rng.uniform(0, i, d, STREAM_INIT);
+            population.at(i, d) = params.tlbo.lower[d] + r * (params.tlbo.upper[d] - params.tlbo.lower[d]);
+        }
+    }
+
+    optimizer.updateFingerprint();
+    objectives = evaluate(population);
+
+    std::vector<ParetoSolution> initial(p);
+    for (size_t i = 0; i < p; ++i) {
+        initial[i] = {population.row(i), objectives[i]};
+    }
+    updateArchive(initial);
+}
+
+void MOTLBO::teacherPhase() {
+    const size_t p = population.size();
+
+    std::vector<double> mean;
+    population_mean(population, mean);
+    const Candidate& teacher = archive[pickTeacher()].candidate;
+
+    std::vector<double> tf(p);
+    for (size_t i = 0; i < p; ++i) {
+        tf[i] = 1.0 + static_cast<double>(rng.bits(generation, i, 0, STREAM_TEACHING_FACTOR) & 1);
+    }
+    for (size_t d = 0; d < dimensions; ++d) {
+        for (size_t i = 0; i < p; ++i) {
+            random.at(i, d) = rng.uniform(generation, i, d, STREAM_TEACHER_R);
+        }
+    }
+
+    teacher_update(population, random, tf.data(), teacher, mean, proposals);
+    population_clamp(proposals, params.tlbo.lower, params.tlbo.upper);
+    select(evaluate(proposals));
+}
+
+// Направление к партнёру определяется доминированием; для взаимно
+// недоминируемой пары — случайно
+void MOTLBO::learnerPhase() {
+    const size_t p = population.size();
+
+    std::vector<int64_t> partner(p);
+    std::vector<double> direction(p);
+    for (size_t i = 0; i < p; ++i) {
+        size_t j = static_cast<size_t>(rng.uniform(generation, i, 0, STREAM_PARTNER) * (p - 1));
+        if (j >= i) ++j;
+        partner[i] = static_cast<int64_t>(j);
+
+        const ObjectivePoint a = to_point(objectives[i]);
+        const ObjectivePoint b = to_point(objectives[j]);
+        if (dominates(a, b)) {
+            direction[i] = 1.0;
+        } else if (dominates(b, a)) {
+            direction[i] = -1.0;
+        } else {
+            direction[i] = (rng.bits(generation, i, 1, STREAM_PARTNER) & 1) ? 1.0 : -1.0;
+        }
+    }
+    for (size_t d = 0; d < dimensions; ++d) {
+        for (size_t i = 0; i < p; ++i) {
+            random.at(i, d) = rng.uniform(generation, i, d, STREAM_LEARNER_R);
+        }
+    }
+
+    learner_update(population, random, direction.data(), partner.data(), proposals);
+    population_clamp(proposals, params.tlbo.lower, params.tlbo.upper);
+    select(evaluate(proposals));
+}
+
+void MOTLBO::step() {
+    teacherPhase();
+    learnerPhase();
+    ++generation;
+}
+
+bool MOTLBO::finished() const {
+    if (generation >= params.tlbo.max_generations) return true;
+    if (params.tlbo.max_evaluations != 0 && evaluations >= params.tlbo.max_evaluations) return true;
+    return false;
+}
+
+MOTLBOResult MOTLBO::run() {
+    initialize();
+    while (!finished()) {
+        step();
+    }
+
+    MOTLBOResult result;
+    result.front = archive;
+    result.generations = generation;
+    result.evaluations = evaluations;
+    return result;
+}
@@ -0,0 +1,67 @@
+#ifndef MO_TLBO_HPP
+#define MO_TLBO_HPP
+
+#include <vector>
+#include <cstddef>
+#include "tlbo.hpp"
+#include "pareto.hpp"
+
+struct ParetoSolution {
+    Candidate candidate;
+    Objectives objectives;
+};
+
+struct MOTLBOParams {
+    TLBOParams tlbo;                 // используются размер популяции, границы, seed и лимиты
+    size_t archive_size = 100;       // предел архива недоминируемых решений
+};
+
+struct MOTLBOResult {
+    std::vector<ParetoSolution> front;   // архив в порядке убывания незаметности
+    size_t generations = 0;
+    size_t evaluations = 0;
+};
+
+// Многокритериальный TLBO: незаметность и устойчивость вместо их произведения.
+// Предложения фазы вместе с текущей популяцией проходят недоминируемую
+// сортировку, и следующая популяция отбирается по рангу и расстоянию
+// скученности (как в NSGA-II). Учитель — наименее скученное решение архива.
+// Критерии каждого кандидата вычисляются один раз и переиспользуются для
+// всех ранжирований.
+class MOTLBO {
+public:
+    MOTLBO(Optimizer& optimizer, const MOTLBOParams& params);
+
+    MOTLBOResult run();
+
+    void initialize();
+    void step();
+    bool finished() const;
+
+    const std::vector<ParetoSolution>& getArchive() const { return archive; }
+
+private:
+    Optimizer& optimizer;
+    MOTLBOParams params;
+    CounterRNG rng;
+    size_t dimensions;
+    size_t generation = 0;
+    size_t evaluations = 0;
+
+    Population population;
+    std::vector<Objectives> objectives;
+    Population proposals;
+    Population random;
+    std::vector<ParetoSolution> archive;
+
+    std::vector<Objectives> evaluate(const Population& candidates);
+    void select(const std::vector<Objectives>& proposal_objectives);
+    void updateArchive(const std::vector<ParetoSolution>& candidates);
+    size_t pickTeacher() const;
+    void teacherPhase();
+    void learnerPhase();
+};
+
+ObjectivePoint to_point(const Objectives& objectives);
+
+#endif // MO_TLBO_HPP
@@ -1,4 +1,10 @@
 #include "objective_function.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+#include <limits>
+#include <functional>
 
 double Optimizer::calculateObjectiveFunction() {
     double total_F = 0.0;
@@ -10,20 +16,22 @@ double Optimizer::calculateObjectiveFunction() {
         const PFM& pack = packs[i];
         const size_t m = pack.attack_weights.size();
 
-        double psnr = image_psnr(pack.src_image, pack.src_image);
-        double ssim = image_ssim(pack.src_image, pack.src_image);
-        double nc = image_nc(pack.src_wm, pack.src_wm);
-        double ber = image_ber(pack.src_wm, pack.src_wm);
+        const ImageQuality quality = timed(STAGE_QUALITY, i, NO_INDEX, [&] { return image_quality(pack.src_image, pack.src_image); });
+        double psnr = quality.psnr;
+        double ssim = quality.ssim;
+        const WMComparison clean = compareWM(pack, i, NO_INDEX, pack.src_wm);
+        double nc = clean.nc;
+        double ber = clean.ber;
         
         const double omega = (psnr / 100.0) * ssim * nc * (1 - ber);
 
         double sum_attacks = 0.0;
         for (size_t j = 0; j < m; ++j) {
-            const Image& attacked_img = pack.attacked[j];
             const WM& extracted_wm = pack.extracted_wms[j];
 
-            double nc_j = image_nc(pack.src_wm, extracted_wm);
-            double ber_j = image_ber(pack.src_wm, extracted_wm);
+            const WMComparison comparison = compareWM(pack, i, j, extracted_wm);
+            double nc_j = comparison.nc;
+            double ber_j = comparison.ber;
 
             sum_attacks += pack.attack_weights[j] * nc_j * (1 - ber_j);
         }
@@ -32,4 +40,464 @@ double Optimizer::calculateObjectiveFunction() {
     }
 
     return total_F / (n * packs[0].attack_weights.size()); 
-}
\ No newline at end of file
+}
+
+double Optimizer::normalization() const {
+    return static_cast<double>(packs.size() * packs[0].attack_weights.size());
+}
+
+size_t Optimizer::packIndex(const PFM& pack) const {
+    if (packs.empty()) return NO_INDEX;
+    const std::less<const PFM*> before;
+    if (before(&pack, packs.data()) || !before(&pack, packs.data() + packs.size())) return NO_INDEX;
+    return static_cast<size_t>(&pack - packs.data());
+}
+
+// Эталоны годны, только пока построены по текущему отпечатку packs.
+// Для пачек вне packs (уровни пирамиды) или устаревших эталонов эталон
+// строится на месте — тот же один проход, только с пересчётом норм
+WMComparison Optimizer::compareWM(const PFM& pack, size_t i, size_t attack, const WM& extracted) const {
+    StageTimer timer(profiler, STAGE_COMPARE, i, attack);
+    if (i < wm_references.size() && wm_references.size() == packs.size() &&
+        wm_references_fingerprint == dataset_fingerprint) {
+        return wm_references[i].compare(extracted);
+    }
+    return WMReference(pack.src_wm).compare(extracted);
+}
+
+double Optimizer::packOmega(const Candidate& candidate, const PFM& pack, const Image& marked) const {
+    const size_t i = packIndex(pack);
+
+    // Встраивание и извлечение без атак — незаметность и точность извлечения
+    const WM clean_wm = timed(STAGE_EXTRACT, i, NO_INDEX, [&] { return pipeline.extract(candidate, pack, marked); });
+
+    const ImageQuality quality = timed(STAGE_QUALITY, i, NO_INDEX, [&] { return image_quality(pack.src_image, marked); });
+    const double psnr = quality.psnr;
+    const double ssim = quality.ssim;
+    const WMComparison clean = compareWM(pack, i, NO_INDEX, clean_wm);
+    const double nc = clean.nc;
+    const double ber = clean.ber;
+
+    return (psnr / 100.0) * ssim * nc * (1 - ber);
+}
+
+double Optimizer::attackTerm(const Candidate& candidate, const PFM& pack, const Image& marked, size_t j) const {
+    const size_t i = packIndex(pack);
+    const Image attacked_img = timed(STAGE_ATTACK, i, j, [&] { return pipeline.attack(marked, j); });
+    const WM extracted_wm = timed(STAGE_EXTRACT, i, j, [&] { return pipeline.extract(candidate, pack, attacked_img); });
+
+    const WMComparison comparison = compareWM(pack, i, j, extracted_wm);
+
+    return comparison.nc * (1 - comparison.ber);
+}
+
+// При отмене оставшиеся стадии не запускаются, и результат — NaN:
+// он не проходит ни одно сравнение и не попадает в кэш
+double Optimizer::packFitness(const Candidate& candidate, const PFM& pack) const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (cancelled()) return nan;
+    const Image marked = timed(STAGE_EMBED, packIndex(pack), NO_INDEX, [&] { return pipeline.embed(candidate, pack); });
+    const double omega = packOmega(candidate, pack, marked);
+
+    double sum_attacks = 0.0;
+    for (size_t j = 0; j < pack.attack_weights.size(); ++j) {
+        if (cancelled()) return nan;
+        sum_attacks += pack.attack_weights[j] * attackTerm(candidate, pack, marked, j);
+    }
+
+    return omega * sum_attacks;
+}
+
+// fitness здесь — ненормированное omega * sum_attacks пачки
+Objectives Optimizer::packObjectives(const Candidate& candidate, const PFM& pack) const {
+    const size_t i = packIndex(pack);
+    const Image marked = timed(STAGE_EMBED, i, NO_INDEX, [&] { return pipeline.embed(candidate, pack); });
+    const WM clean_wm = timed(STAGE_EXTRACT, i, NO_INDEX, [&] { return pipeline.extract(candidate, pack, marked); });
+
+    const ImageQuality quality = timed(STAGE_QUALITY, i, NO_INDEX, [&] { return image_quality(pack.src_image, marked); });
+    const double psnr = quality.psnr;
+    const double ssim = quality.ssim;
+    const WMComparison clean = compareWM(pack, i, NO_INDEX, clean_wm);
+    const double nc = clean.nc;
+    const double ber = clean.ber;
+
+    double sum_attacks = 0.0;
+    for (size_t j = 0; j < pack.attack_weights.size(); ++j) {
+        sum_attacks += pack.attack_weights[j] * attackTerm(candidate, pack, marked, j);
+    }
+
+    Objectives result;
+    result.imperceptibility = (psnr / 100.0) * ssim;
+    result.robustness = nc * (1 - ber) * sum_attacks;
+    result.fitness = result.imperceptibility * result.robustness;
+    return result;
+}
+
+double Optimizer::calculateObjectiveFunction(const Candidate& candidate) const {
+    double total_F = 0.0;
+    const size_t n = packs.size();
+    if (n == 0) return 0.0;
+
+    #pragma omp parallel for reduction(+:total_F)
+    for (size_t i = 0; i < n; ++i) {
+        total_F += packFitness(candidate, packs[i]);
+    }
+
+    return total_F / normalization();
+}
+
+std::vector<double> Optimizer::evaluateBatch(std::span<const Candidate> candidates) const {
+    return evaluateBatch(candidates, packs);
+}
+
+std::vector<double> Optimizer::evaluateBatch(std::span<const Candidate> candidates, const std::vector<PFM>& set) const {
+    const size_t p = candidates.size();
+    const size_t n = set.size();
+    std::vector<double> fitness(p, 0.0);
+    if (p == 0 || n == 0) return fitness;
+
+    // Порядок обхода «пачка — кандидаты»: соседние итерации делят одну пачку,
+    // поэтому потоки одновременно работают с одними и теми же данными.
+    // Каждая пара (кандидат, пачка) остаётся отдельной задачей для балансировки.
+    std::vector<double> partial(n * p);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t k = 0; k < n * p; ++k) {
+        partial[k] = packFitness(candidates[k % p], set[k / p]);
+    }
+
+    const double norm = normalization();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < p; ++c) {
+            fitness[c] += partial[i * p + c];
+        }
+    }
+    for (double& f : fitness) {
+        f /= norm;
+    }
+
+    return fitness;
+}
+
+std::vector<Objectives> Optimizer::evaluateObjectives(const std::vector<Candidate>& population) const {
+    const size_t p = population.size();
+    const size_t n = packs.size();
+    std::vector<Objectives> result(p);
+    if (p == 0 || n == 0) return result;
+
+    std::vector<Objectives> partial(n * p);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t k = 0; k < n * p; ++k) {
+        partial[k] = packObjectives(population[k % p], packs[k / p]);
+    }
+
+    const double norm = normalization();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < p; ++c) {
+            const Objectives& part = partial[i * p + c];
+            result[c].imperceptibility += part.imperceptibility;
+            result[c].robustness += part.robustness;
+            result[c].fitness += part.fitness;
+        }
+    }
+    for (Objectives& objectives : result) {
+        objectives.imperceptibility /= n;
+        objectives.robustness /= norm;
+        objectives.fitness /= norm;
+    }
+
+    // Скалярное значение совпадает с кэшируемым F, поэтому кэш можно пополнить
+    if (cache != nullptr) {
+        FitnessKey key;
+        for (size_t c = 0; c < p; ++c) {
+            if (cache->makeKey(population[c], dataset_fingerprint, key)) cache->insert(key, result[c].fitness);
+        }
+    }
+
+    return result;
+}
+
+Subsample Optimizer::drawSubsample(double fraction, const CounterRNG& rng, uint64_t draw) const {
+    Subsample subsample;
+    subsample.fraction = std::clamp(fraction, 0.0, 1.0);
+    const size_t n = packs.size();
+
+    std::vector<std::vector<size_t>> strata;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t stratum = pack_strata.empty() ? 0 : pack_strata[i];
+        if (stratum >= strata.size()) strata.resize(stratum + 1);
+        strata[stratum].push_back(i);
+    }
+
+    // Выбор без возвращения: первые k по случайному ключу
+    for (std::vector<size_t>& members : strata) {
+        if (members.empty()) continue;
+        const size_t k = std::max<size_t>(1, static_cast<size_t>(std::ceil(subsample.fraction * members.size())));
+        std::sort(members.begin(), members.end(), [&](size_t a, size_t b) {
+            return rng.bits(draw, a, 0, STREAM_SUBSAMPLE) < rng.bits(draw, b, 0, STREAM_SUBSAMPLE);
+        });
+        for (size_t s = 0; s < k; ++s) {
+            subsample.packs.push_back(members[s]);
+            subsample.pack_scale.push_back(static_cast<double>(members.size()) / k);
+        }
+    }
+
+    size_t cursor = 0;
+    for (size_t s = 0; s < subsample.packs.size(); ++s) {
+        const size_t m = packs[subsample.packs[s]].attack_weights.size();
+        std::vector<size_t> chosen;
+        if (m > 0) {
+            std::vector<size_t> perm(m);
+            std::iota(perm.begin(), perm.end(), 0);
+            std::sort(perm.begin(), perm.end(), [&](size_t a, size_t b) {
+                return rng.bits(draw, a, 1, STREAM_SUBSAMPLE) < rng.bits(draw, b, 1, STREAM_SUBSAMPLE);
+            });
+            const size_t k = std::max<size_t>(1, static_cast<size_t>(std::ceil(subsample.fraction * m)));
+            for (size_t t = 0; t < k; ++t) {
+                chosen.push_back(perm[(cursor + t) % m]);
+            }
+            cursor += k;
+        }
+        subsample.attack_scale.push_back(chosen.empty() ? 0.0 : static_cast<double>(m) / chosen.size());
+        subsample.attacks.push_back(std::move(chosen));
+    }
+
+    return subsample;
+}
+
+std::vector<double> Optimizer::evaluateSubsample(const std::vector<Candidate>& population, const Subsample& subsample) const {
+    const size_t p = population.size();
+    const size_t n = subsample.packs.size();
+    std::vector<double> fitness(p, 0.0);
+    if (p == 0 || n == 0) return fitness;
+
+    std::vector<double> partial(n * p);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t k = 0; k < n * p; ++k) {
+        const size_t s = k / p;
+        const Candidate& candidate = population[k % p];
+        const PFM& pack = packs[subsample.packs[s]];
+
+        if (cancelled()) {
+            partial[k] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        const Image marked = timed(STAGE_EMBED, packIndex(pack), NO_INDEX, [&] { return pipeline.embed(candidate, pack); });
+        const double omega = packOmega(candidate, pack, marked);
+
+        double sum_attacks = 0.0;
+        for (size_t j : subsample.attacks[s]) {
+            sum_attacks += pack.attack_weights[j] * attackTerm(candidate, pack, marked, j);
+        }
+        partial[k] = subsample.pack_scale[s] * omega * subsample.attack_scale[s] * sum_attacks;
+    }
+
+    const double norm = normalization();
+    for (size_t s = 0; s < n; ++s) {
+        for (size_t c = 0; c < p; ++c) {
+            fitness[c] += partial[s * p + c];
+        }
+    }
+    for (double& f : fitness) {
+        f /= norm;
+    }
+
+    return fitness;
+}
+
+void Optimizer::buildFidelityLevels(int levels) {
+    pack_levels.clear();
+    pack_levels.resize(levels);
+
+    for (const PFM& pack : packs) {
+        const Image* previous_image = &pack.src_image;
+        const WM* previous_wm = &pack.src_wm;
+        for (int level = 0; level < levels; ++level) {
+            if (previous_image->width / 2 < 4 || previous_image->height / 2 < 4) {
+                throw std::invalid_argument("Optimizer: image too small for the requested pyramid depth");
+            }
+            PFM coarse{Image(), WM(), {}, {}, pack.attack_weights};
+            previous_image->downscale_into(coarse.src_image);
+            previous_wm->downscale_into(coarse.src_wm, false, 1);
+            pack_levels[level].push_back(std::move(coarse));
+            previous_image = &pack_levels[level].back().src_image;
+            previous_wm = &pack_levels[level].back().src_wm;
+        }
+    }
+}
+
+std::vector<double> Optimizer::evaluateLevel(const std::vector<Candidate>& population, int level) const {
+    if (level == 0) return evaluatePopulation(population);
+    if (level < 0 || level > static_cast<int>(pack_levels.size())) {
+        throw std::out_of_range("Optimizer: fidelity level is not built");
+    }
+    return evaluateBatch(population, pack_levels[level - 1]);
+}
+
+void Optimizer::updateFingerprint() {
+    uint64_t hash = fnv1a(nullptr, 0);
+    for (const PFM& pack : packs) {
+        const int dims[] = {pack.src_image.width, pack.src_image.height, pack.src_wm.width, pack.src_wm.height};
+        hash = fnv1a(dims, sizeof(dims), hash);
+        hash = fnv1a(pack.src_image.image_vec.data(), pack.src_image.image_vec.size(), hash);
+        hash = fnv1a(pack.src_wm.image_vec.data(), pack.src_wm.image_vec.size(), hash);
+        hash = fnv1a(pack.attack_weights.data(), pack.attack_weights.size() * sizeof(double), hash);
+    }
+    dataset_fingerprint = hash;
+
+    wm_references.clear();
+    wm_references.reserve(packs.size());
+    for (const PFM& pack : packs) {
+        wm_references.emplace_back(pack.src_wm);
+    }
+    wm_references_fingerprint = dataset_fingerprint;
+}
+
+std::vector<double> Optimizer::evaluatePopulation(const std::vector<Candidate>& population) const {
+    if (cache == nullptr) return evaluateBatch(population);
+
+    std::vector<double> fitness(population.size(), 0.0);
+
+    // Промахи без дубликатов: одинаковые ключи внутри поколения считаются один раз.
+    // Кандидаты без ключа (NaN/inf) вычисляются в обход кэша.
+    std::vector<FitnessKey> keys;
+    std::vector<bool> keyed;
+    std::vector<Candidate> pending;
+    std::unordered_map<FitnessKey, size_t, FitnessKeyHash> pending_slot;
+    std::vector<size_t> slot_of(population.size(), SIZE_MAX);
+
+    for (size_t c = 0; c < population.size(); ++c) {
+        FitnessKey key;
+        if (!cache->makeKey(population[c], dataset_fingerprint, key)) {
+            slot_of[c] = pending.size();
+            pending.push_back(population[c]);
+            keys.emplace_back();
+            keyed.push_back(false);
+            continue;
+        }
+        if (cache->lookup(key, fitness[c])) continue;
+
+        auto [it, inserted] = pending_slot.emplace(key, pending.size());
+        if (inserted) {
+            pending.push_back(population[c]);
+            keys.push_back(std::move(key));
+            keyed.push_back(true);
+        }
+        slot_of[c] = it->second;
+    }
+
+    const std::vector<double> computed = evaluateBatch(pending);
+    for (size_t s = 0; s < pending.size(); ++s) {
+        if (keyed[s] && !std::isnan(computed[s])) cache->insert(keys[s], computed[s]);
+    }
+    for (size_t c = 0; c < population.size(); ++c) {
+        if (slot_of[c] != SIZE_MAX) fitness[c] = computed[slot_of[c]];
+    }
+
+    return fitness;
+}
+
+double Optimizer::evaluateCandidate(const Candidate& candidate) const {
+    FitnessKey key;
+    double fitness = 0.0;
+    const bool keyed = cache != nullptr && cache->makeKey(candidate, dataset_fingerprint, key);
+    if (keyed && cache->lookup(key, fitness)) return fitness;
+
+    if (packs.empty()) return 0.0;
+    double total_F = 0.0;
+    for (const PFM& pack : packs) {
+        total_F += packFitness(candidate, pack);
+    }
+    fitness = total_F / normalization();
+
+    if (keyed && !std::isnan(fitness)) cache->insert(key, fitness);
+    return fitness;
+}
+
+RaceResult Optimizer::raceObjectiveFunction(const Candidate& candidate, double incumbent) const {
+    RaceResult result;
+    const size_t n = packs.size();
+    if (n == 0) return result;
+
+    // Сначала дешёвая часть: встраивание и omega для всех пачек
+    std::vector<Image> marked;
+    std::vector<double> omega(n);
+    marked.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        marked.push_back(timed(STAGE_EMBED, packIndex(packs[i]), NO_INDEX, [&] { return pipeline.embed(candidate, packs[i]); }));
+        omega[i] = packOmega(candidate, packs[i], marked[i]);
+    }
+
+    // 0 <= nc * (1 - ber) <= 1, поэтому невыполненная атака j пачки i добавит не больше
+    // max(omega_i, 0) * w_j (omega бывает отрицательной при отрицательном SSIM).
+    // При бесконечной omega (PSNR = inf у неизменённого изображения) границы нет,
+    // и кандидат досчитывается полностью.
+    bool racing = true;
+    double remaining = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!std::isfinite(omega[i])) racing = false;
+        for (double w : packs[i].attack_weights) {
+            remaining += std::max(omega[i], 0.0) * w;
+        }
+    }
+
+    const double norm = normalization();
+    double total_F = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const PFM& pack = packs[i];
+        for (size_t j = 0; j < pack.attack_weights.size(); ++j) {
+            if (cancelled()) {
+                result.fitness = std::numeric_limits<double>::quiet_NaN();
+                result.abandoned = true;
+                return result;
+            }
+            if (racing && (total_F + remaining) / norm <= incumbent) {
+                result.fitness = (total_F + remaining) / norm;
+                result.abandoned = true;
+                return result;
+            }
+
+            total_F += omega[i] * pack.attack_weights[j] * attackTerm(candidate, pack, marked[i], j);
+            if (racing) remaining -= std::max(omega[i], 0.0) * pack.attack_weights[j];
+            ++result.attacks_run;
+        }
+    }
+
+    result.fitness = total_F / norm;
+    return result;
+}
+
+std::vector<RaceResult> Optimizer::racePopulation(const std::vector<Candidate>& population,
+                                                  const std::vector<double>& incumbents) const {
+    const size_t p = population.size();
+    std::vector<RaceResult> results(p);
+    std::vector<FitnessKey> keys(p);
+    std::vector<bool> keyed(p, false);
+    std::vector<bool> cached(p, false);
+
+    if (cache != nullptr) {
+        for (size_t c = 0; c < p; ++c) {
+            keyed[c] = cache->makeKey(population[c], dataset_fingerprint, keys[c]);
+            cached[c] = keyed[c] && cache->lookup(keys[c], results[c].fitness);
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t c = 0; c < p; ++c) {
+        if (cached[c]) continue;
+        results[c] = raceObjectiveFunction(population[c], incumbents[c]);
+    }
+
+    // В кэш попадают только доведённые до конца (точные) значения
+    if (cache != nullptr) {
+        for (size_t c = 0; c < p; ++c) {
+            if (keyed[c] && !cached[c] && !results[c].abandoned) {
+                cache->insert(keys[c], results[c].fitness);
+            }
+        }
+    }
+
+    return results;
+}
@@ -1,7 +1,14 @@
 #ifndef OBJECTIVE_FUNCTION_HPP
 #define OBJECTIVE_FUNCTION_HPP
 
+#include <functional>
+#include <cstdint>
+#include <span>
 #include "metrics/metrics.hpp"
+#include "fitness_cache.hpp"
+#include "philox.hpp"
+#include "cancel_token.hpp"
+#include "profiler.hpp"
 
 struct PFM { 
     Image src_image;                 
@@ -11,9 +18,124 @@ struct PFM {
     std::vector<double> attack_weights;   
 };
 
+// Кандидат TLBO — вектор параметров встраивания
+using Candidate = std::vector<double>;
+
+// Стадии конвейера встраивание → атака → извлечение.
+// Возвращаемые изображения и ЦВЗ должны иметь заполненные r_lay/g_lay/b_lay.
+struct Pipeline {
+    std::function<Image(const Candidate&, const PFM&)> embed;
+    std::function<Image(const Image&, size_t)> attack;  // j-я атака из attack_weights
+    std::function<WM(const Candidate&, const PFM&, const Image&)> extract;
+};
+
+// Результат оценки с досрочным отсечением
+struct RaceResult {
+    double fitness = 0.0;    // точное значение, либо верхняя граница при abandoned
+    bool abandoned = false;  // кандидат не может превзойти incumbent
+    size_t attacks_run = 0;  // сколько атак фактически выполнено
+};
+
+// Отдельные критерии для многокритериального режима (оба максимизируются).
+// Для каждой пачки omega * sum_attacks = imperceptibility_i * robustness_i.
+struct Objectives {
+    double imperceptibility = 0.0;  // среднее psnr/100 * ssim
+    double robustness = 0.0;        // nc*(1-ber) без атак · Σ w_j nc_j (1-ber_j), нормированное как F
+    double fitness = 0.0;           // скалярное значение calculateObjectiveFunction
+};
+
+// Стратифицированная подвыборка пачек и атак для мини-пакетной оценки.
+// Веса pack_scale и attack_scale (обратные вероятности включения) делают
+// оценку F несмещённой.
+struct Subsample {
+    std::vector<size_t> packs;                 // индексы выбранных пачек
+    std::vector<double> pack_scale;            // размер страты / число выбранных в ней
+    std::vector<std::vector<size_t>> attacks;  // индексы атак для каждой выбранной пачки
+    std::vector<double> attack_scale;          // m / число выбранных атак
+    double fraction = 1.0;
+};
+
+constexpr int PYRAMID_LEVELS = 3;  // 1/2, 1/4, 1/8
+
 class Optimizer {
 public:
     std::vector<PFM> packs; 
+    Pipeline pipeline;
+    FitnessCache* cache = nullptr;     // необязательный кэш значений целевой функции
+    uint64_t dataset_fingerprint = 0;  // отпечаток packs, входит в ключ кэша
+    std::vector<size_t> pack_strata;   // страта каждой пачки для подвыборки; пусто — одна страта
+    std::vector<std::vector<PFM>> pack_levels;  // packs на уровнях пирамиды 1/2, 1/4, 1/8
+    const CancelToken* cancel = nullptr;  // отменённые оценки возвращают NaN и не кэшируются
+    Profiler* profiler = nullptr;         // необязательные счётчики времени по стадиям
+    std::vector<WMReference> wm_references;  // эталоны src_wm пачек, строятся в updateFingerprint
+    uint64_t wm_references_fingerprint = 0;  // dataset_fingerprint, по которому построены wm_references
+
+    bool cancelled() const { return cancel != nullptr && cancel->cancelled(); }
+
+    // Пересчитать отпечаток и эталоны ЦВЗ после изменения packs
+    void updateFingerprint();
+
     double calculateObjectiveFunction();
+
+    // Значение целевой функции для одного кандидата (параллельно по пачкам)
+    double calculateObjectiveFunction(const Candidate& candidate) const;
+
+    // Значения целевой функции для всего поколения: пары (кандидат, пачка)
+    // распределяются по всем ядрам одним параллельным циклом.
+    // При заданном cache повторяющиеся кандидаты не вычисляются заново.
+    std::vector<double> evaluatePopulation(const std::vector<Candidate>& population) const;
+
+    // Пакетная оценка без кэша: пачки обходятся по одной, и все кандидаты
+    // оцениваются на пачке, пока её src_image/src_wm горячие в кэше процессора
+    std::vector<double> evaluateBatch(std::span<const Candidate> candidates) const;
+
+    // Критерии для поколения; каждая пара (кандидат, пачка) вычисляется один раз
+    std::vector<Objectives> evaluateObjectives(const std::vector<Candidate>& population) const;
+
+    // Подвыборка доли fraction пачек каждой страты и доли fraction атак каждой
+    // пачки. Атаки распределяются по выбранным пачкам по кругу из случайной
+    // перестановки, так что все типы атак представлены равномерно.
+    Subsample drawSubsample(double fraction, const CounterRNG& rng, uint64_t draw) const;
+
+    // Несмещённая оценка F по подвыборке, без кэша (в нём только полные значения)
+    std::vector<double> evaluateSubsample(const std::vector<Candidate>& population, const Subsample& subsample) const;
+
+    // Пачки на уменьшенных разрешениях: на каждый уровень src_image уменьшается
+    // вдвое усреднением, src_wm — прореживанием. Пересобирать после изменения packs.
+    void buildFidelityLevels(int levels = PYRAMID_LEVELS);
+
+    // Оценка на уровне пирамиды level (0 — полное разрешение, с кэшем).
+    // Все стадии конвейера линейны или хуже по числу пикселей, поэтому
+    // уровень 2 (1/4) примерно в 16 раз дешевле полной оценки.
+    std::vector<double> evaluateLevel(const std::vector<Candidate>& population, int level) const;
+
+    // Последовательная оценка одного кандидата с учётом cache — для вызова
+    // из кода, который уже распараллелен по кандидатам
+    double evaluateCandidate(const Candidate& candidate) const;
+
+    // Оценка с отсечением: слагаемые sum_attacks накапливаются по одному, и
+    // оставшиеся атаки не запускаются, как только верхняя граница итогового
+    // значения не превышает incumbent. Требует неотрицательных attack_weights.
+    RaceResult raceObjectiveFunction(const Candidate& candidate, double incumbent) const;
+
+    // Гонка для поколения: кандидат c сравнивается с incumbents[c]
+    std::vector<RaceResult> racePopulation(const std::vector<Candidate>& population,
+                                           const std::vector<double>& incumbents) const;
+
+private:
+    std::vector<double> evaluateBatch(std::span<const Candidate> candidates, const std::vector<PFM>& set) const;
+    double packFitness(const Candidate& candidate, const PFM& pack) const;
+    double packOmega(const Candidate& candidate, const PFM& pack, const Image& marked) const;
+    Objectives packObjectives(const Candidate& candidate, const PFM& pack) const;
+    double attackTerm(const Candidate& candidate, const PFM& pack, const Image& marked, size_t j) const;
+    double normalization() const;
+    size_t packIndex(const PFM& pack) const;  // индекс в packs или NO_INDEX (уровни пирамиды)
+    WMComparison compareWM(const PFM& pack, size_t i, size_t attack, const WM& extracted) const;
+
+    template <class StageFn>
+    auto timed(Stage stage, size_t pack, size_t attack, StageFn&& run) const {
+        StageTimer timer(profiler, stage, pack, attack);
+        return run();
+    }
 };
 #endif // OBJECTIVE_FUNCTION_HPP
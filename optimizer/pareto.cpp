@@ -0,0 +1,80 @@
+#include "pareto.hpp"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+bool dominates(const ObjectivePoint& a, const ObjectivePoint& b) {
+    bool strictly_better = false;
+    for (size_t m = 0; m < a.size(); ++m) {
+        if (a[m] < b[m]) return false;
+        if (a[m] > b[m]) strictly_better = true;
+    }
+    return strictly_better;
+}
+
+std::vector<std::vector<size_t>> nondominated_sort(const std::vector<ObjectivePoint>& points) {
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // После сортировки по убыванию решение может доминироваться только предшествующими
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::lexicographical_compare(points[b].begin(), points[b].end(),
+                                            points[a].begin(), points[a].end());
+    });
+
+    std::vector<std::vector<size_t>> fronts;
+    auto dominated_in = [&](const std::vector<size_t>& front, size_t s) {
+        for (auto it = front.rbegin(); it != front.rend(); ++it) {
+            if (dominates(points[*it], points[s])) return true;
+        }
+        return false;
+    };
+
+    for (size_t s : order) {
+        // Если s доминируется во фронте k, то и во всех предыдущих
+        size_t lo = 0;
+        size_t hi = fronts.size();
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (dominated_in(fronts[mid], s)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == fronts.size()) fronts.emplace_back();
+        fronts[lo].push_back(s);
+    }
+
+    return fronts;
+}
+
+std::vector<double> crowding_distance(const std::vector<ObjectivePoint>& points, const std::vector<size_t>& front) {
+    const size_t n = front.size();
+    std::vector<double> distance(n, 0.0);
+    if (n == 0) return distance;
+    if (n <= 2) {
+        std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::infinity());
+        return distance;
+    }
+
+    std::vector<size_t> order(n);
+    for (size_t m = 0; m < points[front[0]].size(); ++m) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return points[front[a]][m] < points[front[b]][m];
+        });
+
+        const double low = points[front[order.front()]][m];
+        const double high = points[front[order.back()]][m];
+        distance[order.front()] = std::numeric_limits<double>::infinity();
+        distance[order.back()] = std::numeric_limits<double>::infinity();
+        if (high - low <= 0.0) continue;
+
+        for (size_t k = 1; k + 1 < n; ++k) {
+            distance[order[k]] += (points[front[order[k + 1]]][m] - points[front[order[k - 1]]][m]) / (high - low);
+        }
+    }
+
+    return distance;
+}
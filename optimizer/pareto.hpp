@@ -0,0 +1,23 @@
+#ifndef PARETO_HPP
+#define PARETO_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Векторы критериев, все критерии максимизируются
+using ObjectivePoint = std::vector<double>;
+
+// a доминирует b: не хуже по всем критериям и строго лучше хотя бы по одному
+bool dominates(const ObjectivePoint& a, const ObjectivePoint& b);
+
+// Быстрая недоминируемая сортировка ENS-BS (Zhang et al., 2015): решения
+// упорядочиваются лексикографически, и каждое бинарным поиском помещается
+// в первый фронт, где его никто не доминирует. O(M N log N) в типичном случае.
+// Возвращает фронты — списки индексов, начиная с недоминируемого.
+std::vector<std::vector<size_t>> nondominated_sort(const std::vector<ObjectivePoint>& points);
+
+// Расстояние скученности (NSGA-II) для решений одного фронта;
+// у крайних точек по каждому критерию — бесконечность
+std::vector<double> crowding_distance(const std::vector<ObjectivePoint>& points, const std::vector<size_t>& front);
+
+#endif // PARETO_HPP
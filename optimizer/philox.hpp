@@ -0,0 +1,78 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// Генератор без состояния: результат зависит только от счётчика и ключа,
+// поэтому любое число можно получить из любого потока без блокировок.
+namespace Philox {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    constexpr uint32_t M0 = 0xD2511F53;
+    constexpr uint32_t M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9;
+    constexpr uint32_t W1 = 0xBB67AE85;
+
+    inline Counter round(const Counter& c, const Key& k) {
+        const uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+        const uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+        return {
+            static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+            static_cast<uint32_t>(p1),
+            static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+            static_cast<uint32_t>(p0)
+        };
+    }
+
+    inline Counter generate(Counter c, Key k) {
+        for (int r = 0; r < 10; ++r) {
+            c = round(c, k);
+            k[0] += W0;
+            k[1] += W1;
+        }
+        return c;
+    }
+}
+
+// Назначение случайного числа внутри поколения — отдельный поток Philox
+enum RandomStream : uint32_t {
+    STREAM_INIT = 0,
+    STREAM_TEACHER_R,
+    STREAM_TEACHING_FACTOR,
+    STREAM_PARTNER,
+    STREAM_LEARNER_R,
+    STREAM_SUBSAMPLE
+};
+
+// Случайные числа TLBO, адресуемые (seed, поколение, особь, измерение, поток).
+// Результат не зависит от числа потоков и порядка вычислений.
+class CounterRNG {
+public:
+    explicit CounterRNG(uint64_t seed = 0) : seed(seed) {}
+
+    uint64_t getSeed() const { return seed; }
+
+    uint64_t bits(uint64_t generation, uint64_t individual, uint64_t dimension, RandomStream stream) const {
+        const Philox::Counter counter = {
+            static_cast<uint32_t>(dimension),
+            static_cast<uint32_t>(individual),
+            static_cast<uint32_t>(generation),
+            static_cast<uint32_t>(stream)
+        };
+        const Philox::Counter out = Philox::generate(counter, {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+        return (static_cast<uint64_t>(out[0]) << 32) | out[1];
+    }
+
+    // Равномерно в [0, 1), 53 значащих бита
+    double uniform(uint64_t generation, uint64_t individual, uint64_t dimension, RandomStream stream) const {
+        return static_cast<double>(bits(generation, individual, dimension, stream) >> 11) * 0x1.0p-53;
+    }
+
+private:
+    uint64_t seed;
+};
+
+#endif // PHILOX_HPP
@@ -0,0 +1,71 @@
+#include "population.hpp"
+#include "simd/dispatch.hpp"
+
+constexpr size_t SIMD_WIDTH = 4;  // double в __m256d
+
+Population::Population(size_t size, size_t dimensions)
+    : count(size), dims(dimensions),
+      stride((size + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH),
+      data(stride * dimensions, 0.0) {}
+
+Candidate Population::row(size_t i) const {
+    Candidate candidate(dims);
+    for (size_t d = 0; d < dims; ++d) {
+        candidate[d] = at(i, d);
+    }
+    return candidate;
+}
+
+void Population::setRow(size_t i, const Candidate& candidate) {
+    for (size_t d = 0; d < dims; ++d) {
+        at(i, d) = candidate[d];
+    }
+}
+
+void Population::copyRow(size_t i, const Population& source, size_t source_row) {
+    for (size_t d = 0; d < dims; ++d) {
+        at(i, d) = source.at(source_row, d);
+    }
+}
+
+std::vector<Candidate> Population::rows() const {
+    std::vector<Candidate> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = row(i);
+    }
+    return result;
+}
+
+void population_mean(const Population& x, std::vector<double>& mean) {
+    const size_t n = x.size();
+    mean.assign(x.dimensions(), 0.0);
+    if (n == 0) return;
+
+    const simd::Kernels& kernels = simd::kernels();
+    for (size_t d = 0; d < x.dimensions(); ++d) {
+        mean[d] = kernels.sum(x.column(d), n) / n;
+    }
+}
+
+void teacher_update(const Population& x, const Population& r, const double* tf,
+                    const std::vector<double>& teacher, const std::vector<double>& mean, Population& out) {
+    const simd::Kernels& kernels = simd::kernels();
+    for (size_t d = 0; d < x.dimensions(); ++d) {
+        kernels.teacher_step(x.column(d), r.column(d), tf, teacher[d], mean[d], out.column(d), x.size());
+    }
+}
+
+void learner_update(const Population& x, const Population& r, const double* direction,
+                    const int64_t* partner, Population& out) {
+    const simd::Kernels& kernels = simd::kernels();
+    for (size_t d = 0; d < x.dimensions(); ++d) {
+        kernels.learner_step(x.column(d), r.column(d), direction, partner, out.column(d), x.size());
+    }
+}
+
+void population_clamp(Population& x, const std::vector<double>& lower, const std::vector<double>& upper) {
+    const simd::Kernels& kernels = simd::kernels();
+    for (size_t d = 0; d < x.dimensions(); ++d) {
+        kernels.clamp(x.column(d), lower[d], upper[d], x.size());
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef POPULATION_HPP
+#define POPULATION_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "objective_function.hpp"
+
+// Аллокатор с выравниванием по кэш-линии для векторных загрузок
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t alignment{64};
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), alignment)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, alignment); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Популяция в виде структуры массивов: для каждого измерения — свой
+// непрерывный выровненный столбец длины stride (кратно 4 double = 32 байта)
+class Population {
+public:
+    Population() = default;
+    Population(size_t size, size_t dimensions);
+
+    size_t size() const { return count; }
+    size_t dimensions() const { return dims; }
+
+    double* column(size_t d) { return data.data() + d * stride; }
+    const double* column(size_t d) const { return data.data() + d * stride; }
+
+    double at(size_t i, size_t d) const { return data[d * stride + i]; }
+    double& at(size_t i, size_t d) { return data[d * stride + i]; }
+
+    Candidate row(size_t i) const;
+    void setRow(size_t i, const Candidate& candidate);
+    void copyRow(size_t i, const Population& source, size_t source_row);
+    std::vector<Candidate> rows() const;
+
+private:
+    size_t count = 0;
+    size_t dims = 0;
+    size_t stride = 0;
+    AlignedVector<double> data;
+};
+
+// Обновление популяции по столбцам через векторные ядра simd::kernels()
+
+// mean[d] — среднее по столбцу d
+void population_mean(const Population& x, std::vector<double>& mean);
+
+// out = x + r ⊙ (teacher - tf ⊙ mean), tf — по одному значению на особь
+void teacher_update(const Population& x, const Population& r, const double* tf,
+                    const std::vector<double>& teacher, const std::vector<double>& mean, Population& out);
+
+// out = x + r ⊙ direction ⊙ (x - x[partner]), direction = ±1 на особь
+void learner_update(const Population& x, const Population& r, const double* direction,
+                    const int64_t* partner, Population& out);
+
+// Ограничение каждого столбца границами [lower[d], upper[d]]
+void population_clamp(Population& x, const std::vector<double>& lower, const std::vector<double>& upper);
+
+#endif // POPULATION_HPP
@@ -0,0 +1,137 @@
+#include "profiler.hpp"
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::atomic<uint64_t> next_profiler_id{1};
+
+// Последний слот потока: повторный поиск нужен только при смене профилировщика
+struct SlotCache {
+    uint64_t profiler = 0;
+    void* slot = nullptr;
+};
+thread_local SlotCache slot_cache;
+
+} // namespace
+
+const char* stage_name(Stage stage) {
+    switch (stage) {
+        case STAGE_EMBED: return "embed";
+        case STAGE_ATTACK: return "attack";
+        case STAGE_EXTRACT: return "extract";
+        case STAGE_QUALITY: return "quality";
+        case STAGE_COMPARE: return "nc_ber";
+        default: return "unknown";
+    }
+}
+
+Profiler::Profiler(size_t packs, size_t attacks)
+    : id(next_profiler_id.fetch_add(1, std::memory_order_relaxed)), pack_count(packs), attack_count(attacks),
+      start_ticks(now()), start_time(std::chrono::steady_clock::now()) {}
+
+Profiler::~Profiler() {
+    ThreadSlot* slot = slots.load(std::memory_order_acquire);
+    while (slot != nullptr) {
+        ThreadSlot* next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
+
+Profiler::ThreadSlot& Profiler::slot() {
+    if (slot_cache.profiler == id) return *static_cast<ThreadSlot*>(slot_cache.slot);
+
+    const std::thread::id self = std::this_thread::get_id();
+    ThreadSlot* found = slots.load(std::memory_order_acquire);
+    while (found != nullptr && found->owner != self) {
+        found = found->next;
+    }
+
+    if (found == nullptr) {
+        found = new ThreadSlot;
+        found->owner = self;
+        found->attacks = std::make_unique<Counter[]>(attack_count);
+        found->packs = std::make_unique<Counter[]>(pack_count);
+
+        ThreadSlot* head = slots.load(std::memory_order_relaxed);
+        do {
+            found->next = head;
+        } while (!slots.compare_exchange_weak(head, found, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    slot_cache = {id, found};
+    return *found;
+}
+
+void Profiler::record(Stage stage, uint64_t ticks, size_t pack, size_t attack) {
+    ThreadSlot& own = slot();
+    own.stages[stage].add(ticks, true);
+    if (pack < pack_count) own.packs[pack].add(ticks, stage == STAGE_EMBED);
+    if (attack < attack_count) own.attacks[attack].add(ticks, stage == STAGE_ATTACK);
+}
+
+double Profiler::secondsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+    const uint64_t ticks = now() - start_ticks;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return ticks > 0 ? seconds / ticks : 0.0;
+#else
+    return static_cast<double>(std::chrono::steady_clock::period::num) / std::chrono::steady_clock::period::den;
+#endif
+}
+
+std::string Profiler::toJson() const {
+    uint64_t stage_ticks[STAGE_COUNT] = {};
+    uint64_t stage_calls[STAGE_COUNT] = {};
+    std::vector<uint64_t> attack_ticks(attack_count, 0), attack_calls(attack_count, 0);
+    std::vector<uint64_t> pack_ticks(pack_count, 0), pack_calls(pack_count, 0);
+
+    for (const ThreadSlot* slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            stage_ticks[s] += slot->stages[s].ticks.load(std::memory_order_relaxed);
+            stage_calls[s] += slot->stages[s].calls.load(std::memory_order_relaxed);
+        }
+        for (size_t j = 0; j < attack_count; ++j) {
+            attack_ticks[j] += slot->attacks[j].ticks.load(std::memory_order_relaxed);
+            attack_calls[j] += slot->attacks[j].calls.load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < pack_count; ++i) {
+            pack_ticks[i] += slot->packs[i].ticks.load(std::memory_order_relaxed);
+            pack_calls[i] += slot->packs[i].calls.load(std::memory_order_relaxed);
+        }
+    }
+
+    const double scale = secondsPerTick();
+    std::ostringstream out;
+    out << "{\n  \"wall_seconds\": "
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    out << ",\n  \"stages\": {";
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        out << (s ? ", " : "") << "\"" << stage_name(static_cast<Stage>(s)) << "\": {\"seconds\": "
+            << stage_ticks[s] * scale << ", \"calls\": " << stage_calls[s] << "}";
+    }
+
+    out << "},\n  \"attacks\": [";
+    for (size_t j = 0; j < attack_count; ++j) {
+        out << (j ? ", " : "") << "{\"index\": " << j << ", \"seconds\": " << attack_ticks[j] * scale
+            << ", \"calls\": " << attack_calls[j] << "}";
+    }
+
+    out << "],\n  \"packs\": [";
+    for (size_t i = 0; i < pack_count; ++i) {
+        out << (i ? ", " : "") << "{\"index\": " << i << ", \"seconds\": " << pack_ticks[i] * scale
+            << ", \"calls\": " << pack_calls[i] << "}";
+    }
+    out << "]\n}\n";
+
+    return out.str();
+}
+
+bool Profiler::exportJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << toJson();
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,112 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Стадии оценки целевой функции
+enum Stage : uint32_t {
+    STAGE_EMBED = 0,
+    STAGE_ATTACK,
+    STAGE_EXTRACT,
+    STAGE_QUALITY,      // MSE, PSNR и SSIM одним проходом (image_quality)
+    STAGE_COMPARE,      // NC и BER одним проходом (WMReference)
+    STAGE_COUNT
+};
+
+constexpr size_t NO_INDEX = SIZE_MAX;  // стадия не относится к пачке или атаке
+
+const char* stage_name(Stage stage);
+
+// Счётчики времени по стадиям, атакам и пачкам. У каждого потока свой слот
+// (выровненный по строке кэша), который пишет только он сам; слоты связаны
+// в список без блокировок, и экспорт суммирует их. Время меряется rdtsc
+// и переводится в секунды по steady_clock за время жизни профилировщика.
+class Profiler {
+public:
+    Profiler(size_t packs, size_t attacks);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // Атаке j идёт время всех стадий её ветви (атака, извлечение, сравнение ЦВЗ),
+    // пачке — всех стадий на ней. Вызовом атаки считается стадия attack,
+    // вызовом пачки — встраивание.
+    void record(Stage stage, uint64_t ticks, size_t pack, size_t attack);
+
+    // Сводка в JSON: stages, attacks, packs (секунды и число вызовов)
+    std::string toJson() const;
+    bool exportJson(const std::string& path) const;
+
+private:
+    struct Counter {
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> calls{0};
+
+        void add(uint64_t value, bool call) {
+            // Единственный писатель — поток-владелец слота
+            ticks.store(ticks.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            if (call) calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    struct alignas(64) ThreadSlot {
+        std::thread::id owner;
+        Counter stages[STAGE_COUNT];
+        std::unique_ptr<Counter[]> attacks;
+        std::unique_ptr<Counter[]> packs;
+        ThreadSlot* next = nullptr;
+    };
+
+    const uint64_t id;                 // отличает профилировщики в кэше потока
+    const size_t pack_count;
+    const size_t attack_count;
+    std::atomic<ThreadSlot*> slots{nullptr};
+
+    const uint64_t start_ticks;
+    const std::chrono::steady_clock::time_point start_time;
+
+    ThreadSlot& slot();
+    double secondsPerTick() const;
+};
+
+// Замер одной стадии в пределах области видимости; без профилировщика ничего не делает
+class StageTimer {
+public:
+    StageTimer(Profiler* profiler, Stage stage, size_t pack = NO_INDEX, size_t attack = NO_INDEX)
+        : profiler(profiler), stage(stage), pack(pack), attack(attack), start(profiler ? Profiler::now() : 0) {}
+
+    ~StageTimer() {
+        if (profiler) profiler->record(stage, Profiler::now() - start, pack, attack);
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Profiler* profiler;
+    Stage stage;
+    size_t pack;
+    size_t attack;
+    uint64_t start;
+};
+
+#endif // PROFILER_HPP
@@ -0,0 +1,193 @@
+#include "steady_state_tlbo.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include "executor/executor.hpp"
+
+SteadyStateTLBO::SteadyStateTLBO(Optimizer& optimizer, const SteadyStateParams& params)
+    : optimizer(optimizer), params(params), rng(params.tlbo.seed), dimensions(params.tlbo.lower.size()) {
+    const TLBOParams& tlbo = params.tlbo;
+    if (tlbo.lower.size() != tlbo.upper.size() || tlbo.lower.empty()) {
+        throw std::invalid_argument("SteadyStateTLBO: bounds must be non-empty and of equal size");
+    }
+    if (tlbo.population_size < 2) {
+        throw std::invalid_argument("SteadyStateTLBO: population size must be at least 2");
+    }
+    if (tlbo.surrogate_top_k != 0 || tlbo.subsample_min_fraction < 1.0 || tlbo.fidelity_level > 0 ||
+        !tlbo.checkpoint_path.empty()) {
+        throw std::invalid_argument("SteadyStateTLBO: surrogate, subsampling, fidelity levels and checkpoints are not supported");
+    }
+
+    budget = (tlbo.max_evaluations != 0) ? tlbo.max_evaluations : 2 * tlbo.max_generations * tlbo.population_size;
+    if (this->params.workers == 0) {
+        this->params.workers = Executor::instance().getParallelism() + 1;
+    }
+    if (this->params.refresh_interval == 0) {
+        this->params.refresh_interval = tlbo.population_size;
+    }
+}
+
+bool SteadyStateTLBO::nextTask(size_t id, Task& task) {
+    if (auto own = queues[id].pop()) {
+        task = *own;
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    for (size_t k = 1; k < queues.size(); ++k) {
+        if (auto stolen = queues[(id + k) % queues.size()].steal()) {
+            task = *stolen;
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SteadyStateTLBO::push(size_t id, const Task& task) {
+    queues[id].push(task);
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    task_ready.notify_one();
+}
+
+void SteadyStateTLBO::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+}
+
+// Предложение строится по текущему состоянию: учитель и среднее могут отставать
+// на несколько замен — это и есть ленивое обновление
+Candidate SteadyStateTLBO::propose(const Task& task) const {
+    std::shared_lock<std::shared_mutex> lock(state_mutex);
+    const size_t i = task.learner;
+    const size_t p = population.size();
+    Candidate proposal = population.row(i);
+
+    if (task.phase == Phase::Teacher) {
+        const double tf = 1.0 + static_cast<double>(rng.bits(task.step, i, 0, STREAM_TEACHING_FACTOR) & 1);
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double r = rng.uniform(task.step, i, d, STREAM_TEACHER_R);
+            proposal[d] += r * (population.at(teacher, d) - tf * mean[d]);
+        }
+    } else {
+        size_t j = static_cast<size_t>(rng.uniform(task.step, i, 0, STREAM_PARTNER) * (p - 1));
+        if (j >= i) ++j;
+        const double direction = (fitness[i] > fitness[j]) ? 1.0 : -1.0;
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double r = rng.uniform(task.step, i, d, STREAM_LEARNER_R);
+            proposal[d] += r * direction * (population.at(i, d) - population.at(j, d));
+        }
+    }
+
+    for (size_t d = 0; d < dimensions; ++d) {
+        proposal[d] = std::clamp(proposal[d], params.tlbo.lower[d], params.tlbo.upper[d]);
+    }
+    return proposal;
+}
+
+void SteadyStateTLBO::accept(size_t learner, const Candidate& proposal, double proposal_fitness) {
+    std::unique_lock<std::shared_mutex> lock(state_mutex);
+    if (proposal_fitness <= fitness[learner]) return;
+
+    population.setRow(learner, proposal);
+    fitness[learner] = proposal_fitness;
+    if (proposal_fitness > fitness[teacher]) {
+        teacher = learner;
+    }
+    if (++updates_since_refresh >= params.refresh_interval) {
+        population_mean(population, mean);
+        updates_since_refresh = 0;
+    }
+}
+
+// Рабочий, вышедший по бюджету или с исключением, будит остальных:
+// иначе они ждали бы задач, которые уже никто не положит
+void SteadyStateTLBO::worker(size_t id) {
+    try {
+        work(id);
+    } catch (...) {
+        stop();
+        throw;
+    }
+    stop();
+}
+
+void SteadyStateTLBO::work(size_t id) {
+    Task task;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (!nextTask(id, task)) {
+            // Очереди пусты: все цепочки сейчас у других рабочих
+            std::unique_lock<std::mutex> lock(wait_mutex);
+            task_ready.wait(lock, [this] { return queued.load() > 0 || stopping.load(); });
+            continue;
+        }
+        if (issued.fetch_add(1, std::memory_order_relaxed) >= budget) break;
+
+        const Candidate proposal = propose(task);
+        double proposal_fitness;
+        if (params.tlbo.racing) {
+            double incumbent;
+            {
+                std::shared_lock<std::shared_mutex> lock(state_mutex);
+                incumbent = fitness[task.learner];
+            }
+            const RaceResult race = optimizer.raceObjectiveFunction(proposal, incumbent);
+            proposal_fitness = race.abandoned ? -std::numeric_limits<double>::infinity() : race.fitness;
+            if (race.abandoned) abandoned.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            proposal_fitness = optimizer.evaluateCandidate(proposal);
+        }
+        accept(task.learner, proposal, proposal_fitness);
+
+        // Следующий шаг этого ученика остаётся у того же потока
+        if (task.phase == Phase::Teacher) {
+            push(id, {task.learner, Phase::Learner, task.step});
+        } else {
+            push(id, {task.learner, Phase::Teacher, task.step + 1});
+        }
+    }
+}
+
+TLBOResult SteadyStateTLBO::run() {
+    const size_t p = params.tlbo.population_size;
+    population = Population(p, dimensions);
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double r = rng.uniform(0, i, d, STREAM_INIT);
+            population.at(i, d) = params.tlbo.lower[d] + r * (params.tlbo.upper[d] - params.tlbo.lower[d]);
+        }
+    }
+
+    optimizer.updateFingerprint();
+    fitness = optimizer.evaluatePopulation(population.rows());
+    teacher = std::max_element(fitness.begin(), fitness.end()) - fitness.begin();
+    population_mean(population, mean);
+    updates_since_refresh = 0;
+
+    issued = p;
+    abandoned = 0;
+    steals = 0;
+    stopping = false;
+    queues = std::vector<WorkStealingDeque<Task>>(params.workers);
+    for (size_t i = 0; i < p; ++i) {
+        queues[i % params.workers].push({i, Phase::Teacher, 1});
+    }
+    queued = p;
+
+    Executor::instance().parallel_for(params.workers, [this](size_t id) { worker(id); });
+
+    TLBOResult result;
+    result.best = population.row(teacher);
+    result.best_fitness = fitness[teacher];
+    result.evaluations = std::min(issued.load(), budget);
+    result.generations = result.evaluations / (2 * p);
+    result.abandoned = abandoned.load();
+    return result;
+}
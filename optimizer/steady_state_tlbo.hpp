@@ -0,0 +1,79 @@
+#ifndef STEADY_STATE_TLBO_HPP
+#define STEADY_STATE_TLBO_HPP
+
+#include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <cstddef>
+#include "tlbo.hpp"
+#include "executor/work_stealing_deque.hpp"
+
+// Из TLBOParams используются границы, population_size, seed, racing и бюджет;
+// stall_generations и tolerance не действуют — останов только по бюджету.
+// Суррогат, подвыборка, грубые уровни и контрольные точки требуют барьера
+// поколения, поэтому конструктор их отвергает.
+struct SteadyStateParams {
+    TLBOParams tlbo;                  // бюджет: max_evaluations, иначе 2 · max_generations · population_size
+    size_t workers = 0;               // 0 — вызывающий поток и все помощники Executor
+    size_t refresh_interval = 0;      // принятых замен между пересчётами среднего; 0 — population_size
+};
+
+// Асинхронный (steady-state) TLBO без барьера между поколениями.
+// У каждого ученика своя цепочка задач «фаза учителя → фаза ученика → ...»;
+// цепочки лежат в очередях рабочих потоков, простаивающий поток крадёт задачи
+// у соседей. Результат оценки сразу применяется к популяции, учитель
+// обновляется при каждом улучшении, среднее — лениво, раз в refresh_interval
+// замен. Порядок применения зависит от времени выполнения, поэтому запуски
+// с разным числом потоков не совпадают побитно. Цепочки выполняются на общем
+// Executor: рабочих одновременно не больше, чем ему позволяет бюджет.
+class SteadyStateTLBO {
+public:
+    SteadyStateTLBO(Optimizer& optimizer, const SteadyStateParams& params);
+
+    TLBOResult run();
+
+    size_t getSteals() const { return steals.load(); }
+
+private:
+    enum class Phase { Teacher, Learner };
+
+    struct Task {
+        size_t learner;
+        Phase phase;
+        size_t step;                  // номер шага ученика — «поколение» для Philox
+    };
+
+    Optimizer& optimizer;
+    SteadyStateParams params;
+    CounterRNG rng;
+    size_t dimensions;
+    size_t budget = 0;
+
+    Population population;
+    std::vector<double> fitness;
+    std::vector<double> mean;
+    size_t teacher = 0;
+    size_t updates_since_refresh = 0;
+    mutable std::shared_mutex state_mutex;
+
+    std::vector<WorkStealingDeque<Task>> queues;
+    std::atomic<size_t> queued{0};    // задач в очередях; ждущие рабочие спят до появления новой
+    std::atomic<bool> stopping{false};
+    std::mutex wait_mutex;
+    std::condition_variable task_ready;
+    std::atomic<size_t> issued{0};
+    std::atomic<size_t> abandoned{0};
+    std::atomic<size_t> steals{0};
+
+    void worker(size_t id);
+    void work(size_t id);
+    bool nextTask(size_t id, Task& task);
+    void push(size_t id, const Task& task);
+    void stop();
+    Candidate propose(const Task& task) const;
+    void accept(size_t learner, const Candidate& proposal, double proposal_fitness);
+};
+
+#endif // STEADY_STATE_TLBO_HPP
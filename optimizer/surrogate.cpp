@@ -0,0 +1,124 @@
+#include "surrogate.hpp"
+#include <cmath>
+#include <stdexcept>
+
+RBFSurrogate::RBFSurrogate(const std::vector<double>& lower, const std::vector<double>& upper,
+                           size_t capacity, double ridge)
+    : lower(lower), upper(upper), capacity(capacity), ridge(ridge) {
+    if (lower.size() != upper.size() || capacity < 2) {
+        throw std::invalid_argument("RBFSurrogate: bad bounds or capacity");
+    }
+}
+
+std::vector<double> RBFSurrogate::normalize(const std::vector<double>& x) const {
+    std::vector<double> u(x.size());
+    for (size_t d = 0; d < x.size(); ++d) {
+        const double span = upper[d] - lower[d];
+        u[d] = (span > 0.0) ? (x[d] - lower[d]) / span : 0.0;
+    }
+    return u;
+}
+
+double RBFSurrogate::kernel(const std::vector<double>& a, const std::vector<double>& b) const {
+    double dist2 = 0.0;
+    for (size_t d = 0; d < a.size(); ++d) {
+        const double diff = a[d] - b[d];
+        dist2 += diff * diff;
+    }
+    return std::exp(-dist2 / (2.0 * width * width));
+}
+
+void RBFSurrogate::add(const std::vector<double>& x, double y) {
+    if (!std::isfinite(y)) return;
+
+    if (samples.size() < capacity) {
+        samples.push_back(normalize(x));
+        values.push_back(y);
+    } else {
+        samples[next] = normalize(x);
+        values[next] = y;
+        next = (next + 1) % capacity;
+    }
+    dirty = true;
+}
+
+// Решение (K + ridge·I) w = y - mean разложением Холецкого
+void RBFSurrogate::fit() {
+    const size_t n = samples.size();
+
+    double mean_dist = 0.0;
+    size_t pairs = 0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double dist2 = 0.0;
+            for (size_t d = 0; d < samples[i].size(); ++d) {
+                const double diff = samples[i][d] - samples[j][d];
+                dist2 += diff * diff;
+            }
+            mean_dist += std::sqrt(dist2);
+            ++pairs;
+        }
+    }
+    width = (pairs > 0 && mean_dist > 0.0) ? mean_dist / pairs : 1.0;
+
+    offset = 0.0;
+    for (double v : values) offset += v;
+    offset /= n;
+
+    std::vector<double> L(n * n, 0.0);
+    double jitter = ridge;
+    bool ok = false;
+    for (int attempt = 0; attempt < 8; ++attempt, jitter *= 100.0) {
+        ok = true;
+        for (size_t i = 0; i < n && ok; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                double sum = kernel(samples[i], samples[j]) + ((i == j) ? jitter : 0.0);
+                for (size_t k = 0; k < j; ++k) {
+                    sum -= L[i * n + k] * L[j * n + k];
+                }
+                if (i == j) {
+                    if (!(sum > 0.0)) { ok = false; break; }
+                    L[i * n + i] = std::sqrt(sum);
+                } else {
+                    L[i * n + j] = sum / L[j * n + j];
+                }
+            }
+        }
+        if (ok) break;
+    }
+
+    dirty = false;
+    fitted = ok;
+    weights.assign(n, 0.0);
+    if (!fitted) return;
+
+    for (size_t i = 0; i < n; ++i) {
+        double sum = values[i] - offset;
+        for (size_t k = 0; k < i; ++k) sum -= L[i * n + k] * weights[k];
+        weights[i] = sum / L[i * n + i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        double sum = weights[i];
+        for (size_t k = i + 1; k < n; ++k) sum -= L[k * n + i] * weights[k];
+        weights[i] = sum / L[i * n + i];
+    }
+}
+
+bool RBFSurrogate::ready(size_t min_samples) {
+    if (samples.size() < min_samples) return false;
+    if (dirty) fit();
+    return fitted;
+}
+
+double RBFSurrogate::predict(const std::vector<double>& x) {
+    if (samples.empty()) return 0.0;
+    if (dirty) fit();
+    if (!fitted) return offset;
+
+    const std::vector<double> u = normalize(x);
+    double y = offset;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        y += weights[i] * kernel(u, samples[i]);
+    }
+    return y;
+}
@@ -0,0 +1,53 @@
+#ifndef SURROGATE_HPP
+#define SURROGATE_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Суррогатная модель целевой функции: интерполяция гауссовыми радиальными
+// базисными функциями с регуляризацией. Обучается онлайн на парах
+// (кандидат, значение); хранит не более capacity последних образцов.
+class RBFSurrogate {
+public:
+    RBFSurrogate(const std::vector<double>& lower, const std::vector<double>& upper,
+                 size_t capacity = 256, double ridge = 1e-6);
+
+    void add(const std::vector<double>& x, double y);
+    double predict(const std::vector<double>& x);
+    // Образцов не меньше min_samples и модель обучена; если разложение
+    // не удалось даже с наибольшей регуляризацией, прогнозам верить нельзя
+    bool ready(size_t min_samples);
+    size_t size() const { return samples.size(); }
+
+private:
+    std::vector<double> lower;
+    std::vector<double> upper;
+    size_t capacity;
+    double ridge;
+
+    std::vector<std::vector<double>> samples;  // нормированные в [0, 1] входы
+    std::vector<double> values;
+    size_t next = 0;                           // слот для замены при заполнении
+
+    bool dirty = true;
+    bool fitted = false;                       // последнее разложение удалось
+    double width = 1.0;
+    double offset = 0.0;
+    std::vector<double> weights;
+
+    std::vector<double> normalize(const std::vector<double>& x) const;
+    double kernel(const std::vector<double>& a, const std::vector<double>& b) const;
+    void fit();
+};
+
+// Точность суррогата и экономия оценок за одну фазу поколения
+struct SurrogateStats {
+    size_t generation = 0;
+    size_t proposals = 0;
+    size_t evaluated = 0;        // отправлено в настоящую целевую функцию
+    size_t saved = 0;            // отсеяно суррогатом
+    double mean_abs_error = 0.0; // по реально оценённым предложениям
+    double agreement = 0.0;      // доля совпадений прогноза «лучше/хуже текущего ученика»
+};
+
+#endif // SURROGATE_HPP
@@ -0,0 +1,473 @@
+#include "tlbo.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+TLBO::TLBO(Optimizer& optimizer, const TLBOParams& params)
+    : optimizer(optimizer), params(params), rng(params.seed) {
+    if (params.lower.size() != params.upper.size() || params.lower.empty()) {
+        throw std::invalid_argument("TLBO: bounds must be non-empty and of equal size");
+    }
+    if (params.population_size < 2) {
+        throw std::invalid_argument("TLBO: population size must be at least 2");
+    }
+    dimensions = params.lower.size();
+    if (params.surrogate_top_k != 0) {
+        surrogate = std::make_unique<RBFSurrogate>(params.lower, params.upper, params.surrogate_capacity);
+    }
+}
+
+std::vector<double> TLBO::evaluate(const std::vector<Candidate>& candidates) {
+    evaluations += candidates.size();
+    exact.assign(candidates.size(), true);
+    if (subsampling()) return optimizer.evaluateSubsample(candidates, subsample);
+    return optimizer.evaluatePopulation(candidates);
+}
+
+std::vector<double> TLBO::evaluateCoarse(const std::vector<Candidate>& candidates) {
+    coarse_evaluations += candidates.size();
+    return optimizer.evaluateLevel(candidates, params.fidelity_level);
+}
+
+void TLBO::scoreCoarse() {
+    if (!coarseScreening()) return;
+    if (static_cast<int>(optimizer.pack_levels.size()) < params.fidelity_level) {
+        optimizer.buildFidelityLevels(params.fidelity_level);
+    }
+    coarse_fitness = evaluateCoarse(population.rows());
+}
+
+// Предложение i сравнивается только с incumbents[i], поэтому при racing
+// достаточно знать, что оно его не превзойдёт
+std::vector<double> TLBO::evaluateProposals(const std::vector<Candidate>& proposals, const std::vector<double>& incumbents) {
+    if (!params.racing || subsampling()) return evaluate(proposals);
+
+    evaluations += proposals.size();
+    const std::vector<RaceResult> race = optimizer.racePopulation(proposals, incumbents);
+
+    std::vector<double> proposal_fitness(race.size());
+    exact.assign(race.size(), true);
+    for (size_t i = 0; i < race.size(); ++i) {
+        proposal_fitness[i] = race[i].fitness;
+        if (race[i].abandoned) {
+            ++abandoned;
+            exact[i] = false;
+        }
+    }
+    return proposal_fitness;
+}
+
+// С обученным суррогатом настоящую оценку получают только surrogate_top_k
+// предложений с наибольшим прогнозируемым улучшением своего ученика;
+// остальные отклоняются без вычислений. В поколения грубого отбора вместо
+// суррогата работает оценка на уровне пирамиды.
+void TLBO::screenAndAccept() {
+    const size_t p = proposals.size();
+    const bool coarse = coarseScreening();
+    const bool screening = !coarse && surrogate && surrogate->ready(params.surrogate_min_samples) && params.surrogate_top_k < p;
+
+    std::vector<size_t> chosen(p);
+    std::iota(chosen.begin(), chosen.end(), 0);
+    std::vector<double> predicted(p, 0.0);
+    std::vector<double> coarse_proposals;
+
+    if (coarse) {
+        coarse_proposals = evaluateCoarse(proposals.rows());
+        std::erase_if(chosen, [&](size_t i) { return coarse_proposals[i] <= coarse_fitness[i]; });
+        std::stable_sort(chosen.begin(), chosen.end(), [&](size_t a, size_t b) {
+            return coarse_proposals[a] - coarse_fitness[a] > coarse_proposals[b] - coarse_fitness[b];
+        });
+        if (params.fidelity_promote != 0 && params.fidelity_promote < chosen.size()) {
+            chosen.resize(params.fidelity_promote);
+        }
+    } else if (screening) {
+        for (size_t i = 0; i < p; ++i) {
+            predicted[i] = surrogate->predict(proposals.row(i));
+        }
+        std::partial_sort(chosen.begin(), chosen.begin() + params.surrogate_top_k, chosen.end(),
+                          [&](size_t a, size_t b) { return predicted[a] - fitness[a] > predicted[b] - fitness[b]; });
+        chosen.resize(params.surrogate_top_k);
+    }
+
+    std::vector<Candidate> subset;
+    std::vector<double> incumbents;
+    subset.reserve(chosen.size());
+    incumbents.reserve(chosen.size());
+    for (size_t i : chosen) {
+        subset.push_back(proposals.row(i));
+        incumbents.push_back(fitness[i]);
+    }
+    const std::vector<double> subset_fitness = subset.empty() ? std::vector<double>() : evaluateProposals(subset, incumbents);
+
+    std::vector<double> proposal_fitness(p, -std::numeric_limits<double>::infinity());
+    SurrogateStats stats;
+    stats.generation = generation;
+    stats.proposals = p;
+    stats.evaluated = chosen.size();
+    stats.saved = p - chosen.size();
+
+    size_t compared = 0;
+    for (size_t s = 0; s < chosen.size(); ++s) {
+        const size_t i = chosen[s];
+        proposal_fitness[i] = subset_fitness[s];
+        if (!exact[s] || std::isnan(subset_fitness[s])) continue;
+
+        if (screening) {
+            stats.mean_abs_error += std::fabs(predicted[i] - subset_fitness[s]);
+            stats.agreement += ((predicted[i] > fitness[i]) == (subset_fitness[s] > fitness[i])) ? 1.0 : 0.0;
+            ++compared;
+        }
+        if (surrogate && !subsampling()) surrogate->add(subset[s], subset_fitness[s]);
+    }
+    if (compared > 0) {
+        stats.mean_abs_error /= compared;
+        stats.agreement /= compared;
+    }
+    if (surrogate) surrogate_stats.push_back(stats);
+
+    if (coarse) {
+        for (size_t i : chosen) {
+            if (proposal_fitness[i] > fitness[i]) coarse_fitness[i] = coarse_proposals[i];
+        }
+    }
+    acceptBetter(proposal_fitness);
+}
+
+// Средний разброс по измерениям относительно разброса равномерного
+// распределения на границах: 1 — начальная популяция, 0 — сошлась в точку
+double TLBO::diversity() const {
+    std::vector<double> mean;
+    population_mean(population, mean);
+
+    const double uniform_std = 1.0 / std::sqrt(12.0);
+    double total = 0.0;
+    for (size_t d = 0; d < dimensions; ++d) {
+        const double* col = population.column(d);
+        double sum_sq = 0.0;
+        for (size_t i = 0; i < population.size(); ++i) {
+            sum_sq += (col[i] - mean[d]) * (col[i] - mean[d]);
+        }
+        const double range = params.upper[d] - params.lower[d];
+        if (range > 0.0) {
+            total += std::sqrt(sum_sq / population.size()) / range / uniform_std;
+        }
+    }
+    return std::min(1.0, total / dimensions);
+}
+
+// Доля подвыборки не убывает; новая подвыборка в каждом поколении, и
+// учеников приходится переоценить на ней, чтобы сравнения внутри
+// поколения шли на одних данных
+void TLBO::resample() {
+    if (!subsampling()) return;
+
+    const double min_fraction = params.subsample_min_fraction;
+    subsample_fraction = std::max(subsample_fraction, min_fraction + (1.0 - min_fraction) * (1.0 - diversity()));
+    if (subsample_fraction >= 1.0) {
+        subsample_fraction = 1.0;
+    } else {
+        subsample = optimizer.drawSubsample(subsample_fraction, rng, generation);
+    }
+
+    // Прерванная переоценка не должна затереть прежние значения
+    std::vector<double> rescored = evaluate(population.rows());
+    if (optimizer.cancelled()) return;
+    fitness = std::move(rescored);
+    best_so_far = fitness[bestIndex()];
+}
+
+// Итоговая оценка на полном наборе: значения подвыборки служат только
+// для отбора subsample_final претендентов. Если оценку прервали, лучший
+// выбирается среди успевших; без них остаётся оценка по подвыборке.
+size_t TLBO::finalEvaluation(bool& exact_best) {
+    std::vector<size_t> order(population.size());
+    std::iota(order.begin(), order.end(), 0);
+    // Прерванные оценки (NaN) — в конец
+    auto rank = [&](size_t i) { return std::isnan(fitness[i]) ? -std::numeric_limits<double>::infinity() : fitness[i]; };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rank(a) > rank(b); });
+    if (params.subsample_final != 0 && params.subsample_final < order.size()) {
+        order.resize(params.subsample_final);
+    }
+
+    subsample_fraction = 1.0;
+    std::vector<Candidate> finalists;
+    finalists.reserve(order.size());
+    for (size_t i : order) {
+        finalists.push_back(population.row(i));
+    }
+    const std::vector<double> full = evaluate(finalists);
+
+    size_t best = order[0];
+    exact_best = false;
+    for (size_t s = 0; s < order.size(); ++s) {
+        if (std::isnan(full[s])) continue;
+        fitness[order[s]] = full[s];
+        if (!exact_best || full[s] > fitness[best]) {
+            best = order[s];
+            exact_best = true;
+        }
+    }
+    return best;
+}
+
+// NaN (прерванная оценка) считается хуже любого значения, как в finalEvaluation;
+// max_element с NaN в диапазоне возвращал бы произвольный элемент
+size_t TLBO::bestIndex() const {
+    size_t best = 0;
+    for (size_t i = 1; i < fitness.size(); ++i) {
+        if (fitness[i] > fitness[best] || std::isnan(fitness[best])) best = i;
+    }
+    return best;
+}
+
+// r для всей популяции; значение зависит только от (поколение, особь, измерение)
+void TLBO::fillRandom(RandomStream stream) {
+    #pragma omp parallel for
+    for (size_t d = 0; d < dimensions; ++d) {
+        double* col = random.column(d);
+        for (size_t i = 0; i < random.size(); ++i) {
+            col[i] = rng.uniform(generation, i, d, stream);
+        }
+    }
+}
+
+void TLBO::initialize() {
+    population = Population(params.population_size, dimensions);
+    proposals = Population(params.population_size, dimensions);
+    random = Population(params.population_size, dimensions);
+
+    generation = 0;
+    fillRandom(STREAM_INIT);
+    for (size_t d = 0; d < dimensions; ++d) {
+        const double* r = random.column(d);
+        double* col = population.column(d);
+        for (size_t i = 0; i < population.size(); ++i) {
+            col[i] = params.lower[d] + r[i] * (params.upper[d] - params.lower[d]);
+        }
+    }
+
+    optimizer.updateFingerprint();
+    evaluations = 0;
+    abandoned = 0;
+    stall = 0;
+    subsample_fraction = std::min(1.0, params.subsample_min_fraction);
+    if (subsampling()) {
+        subsample = optimizer.drawSubsample(subsample_fraction, rng, generation);
+    }
+    const std::vector<Candidate> learners = population.rows();
+    fitness = evaluate(learners);
+    best_so_far = fitness[bestIndex()];
+
+    coarse_evaluations = 0;
+    scoreCoarse();
+
+    if (surrogate && !subsampling()) {
+        for (size_t i = 0; i < learners.size(); ++i) {
+            surrogate->add(learners[i], fitness[i]);
+        }
+    }
+}
+
+// Жадный отбор: новое решение заменяет старое, только если оно лучше
+void TLBO::acceptBetter(const std::vector<double>& proposal_fitness) {
+    for (size_t i = 0; i < population.size(); ++i) {
+        if (proposal_fitness[i] > fitness[i]) {
+            population.copyRow(i, proposals, i);
+            fitness[i] = proposal_fitness[i];
+        }
+    }
+}
+
+// X_new = X + r * (Teacher - Tf * Mean), Tf ∈ {1, 2}
+void TLBO::teacherPhase() {
+    const size_t p = population.size();
+
+    std::vector<double> mean;
+    population_mean(population, mean);
+    const Candidate teacher = population.row(bestIndex());
+
+    std::vector<double> tf(p);
+    for (size_t i = 0; i < p; ++i) {
+        tf[i] = 1.0 + static_cast<double>(rng.bits(generation, i, 0, STREAM_TEACHING_FACTOR) & 1);
+    }
+    fillRandom(STREAM_TEACHER_R);
+
+    teacher_update(population, random, tf.data(), teacher, mean, proposals);
+    population_clamp(proposals, params.lower, params.upper);
+
+    screenAndAccept();
+}
+
+// X_new = X + r * (X - X_j), если X лучше X_j, иначе X + r * (X_j - X)
+void TLBO::learnerPhase() {
+    const size_t p = population.size();
+
+    std::vector<int64_t> partner(p);
+    std::vector<double> direction(p);
+    for (size_t i = 0; i < p; ++i) {
+        size_t j = static_cast<size_t>(rng.uniform(generation, i, 0, STREAM_PARTNER) * (p - 1));
+        if (j >= i) ++j;
+        partner[i] = static_cast<int64_t>(j);
+        direction[i] = (fitness[i] > fitness[j]) ? 1.0 : -1.0;
+    }
+    fillRandom(STREAM_LEARNER_R);
+
+    learner_update(population, random, direction.data(), partner.data(), proposals);
+    population_clamp(proposals, params.lower, params.upper);
+
+    screenAndAccept();
+}
+
+void TLBO::step() {
+    resample();
+    teacherPhase();
+    learnerPhase();
+    ++generation;
+
+    const double best = fitness[bestIndex()];
+    if (best - best_so_far > params.tolerance) {
+        best_so_far = best;
+        stall = 0;
+    } else {
+        ++stall;
+    }
+}
+
+bool TLBO::immigrate(const Candidate& migrant, double migrant_fitness) {
+    // Значение с подвыборки отправителя несравнимо с нашими — пересчёт на своей
+    if (subsampling()) migrant_fitness = evaluate({migrant})[0];
+
+    size_t worst = 0;
+    for (size_t i = 1; i < fitness.size() && !std::isnan(fitness[worst]); ++i) {
+        if (std::isnan(fitness[i]) || fitness[i] < fitness[worst]) worst = i;
+    }
+    if (std::isnan(migrant_fitness) || (!std::isnan(fitness[worst]) && migrant_fitness <= fitness[worst])) return false;
+
+    population.setRow(worst, migrant);
+    fitness[worst] = migrant_fitness;
+    if (coarseScreening()) {
+        coarse_fitness[worst] = evaluateCoarse({migrant})[0];
+    }
+    return true;
+}
+
+bool TLBO::finished() const {
+    if (generation >= params.max_generations) return true;
+    if (params.max_evaluations != 0 && evaluations >= params.max_evaluations) return true;
+    if (params.stall_generations != 0 && stall >= params.stall_generations) return true;
+    return false;
+}
+
+TLBOState TLBO::saveState() const {
+    TLBOState state;
+    state.dimensions = dimensions;
+    state.generation = generation;
+    state.evaluations = evaluations;
+    state.abandoned = abandoned;
+    state.stall = stall;
+    state.best_so_far = best_so_far;
+    state.dataset_fingerprint = optimizer.dataset_fingerprint;
+    state.subsample_fraction = subsample_fraction;
+
+    state.population.reserve(population.size() * dimensions);
+    for (size_t i = 0; i < population.size(); ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            state.population.push_back(population.at(i, d));
+        }
+    }
+    state.fitness = fitness;
+
+    state.rng_seed = rng.getSeed();
+
+    if (optimizer.cache != nullptr) {
+        state.cache = optimizer.cache->snapshot();
+    }
+    return state;
+}
+
+void TLBO::restoreState(const TLBOState& state) {
+    if (state.dimensions != dimensions || state.fitness.empty()) {
+        throw std::invalid_argument("TLBO: checkpoint does not match problem dimensions");
+    }
+
+    const size_t p = state.fitness.size();
+    population = Population(p, dimensions);
+    proposals = Population(p, dimensions);
+    random = Population(p, dimensions);
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t d = 0; d < dimensions; ++d) {
+            population.at(i, d) = state.population[i * dimensions + d];
+        }
+    }
+    fitness = state.fitness;
+    generation = state.generation;
+    evaluations = state.evaluations;
+    abandoned = state.abandoned;
+    stall = state.stall;
+    best_so_far = state.best_so_far;
+
+    rng = CounterRNG(state.rng_seed);
+    // Доля подвыборки не убывает, поэтому продолжаем с сохранённой
+    subsample_fraction = std::clamp(state.subsample_fraction, std::min(1.0, params.subsample_min_fraction), 1.0);
+    if (subsampling()) {
+        subsample = optimizer.drawSubsample(subsample_fraction, rng, generation);
+    }
+
+    optimizer.updateFingerprint();
+    if (optimizer.cache != nullptr) {
+        optimizer.cache->restore(state.cache);
+    }
+    // Точка от другого набора пачек: популяция пригодна как начальная,
+    // но её fitness устарели. Записи кэша отсекаются отпечатком в ключе.
+    if (state.dataset_fingerprint != optimizer.dataset_fingerprint) {
+        fitness = evaluate(population.rows());
+        best_so_far = fitness[bestIndex()];
+        stall = 0;
+    }
+    if (surrogate && !subsampling()) {
+        for (size_t i = 0; i < p; ++i) {
+            surrogate->add(population.row(i), fitness[i]);
+        }
+    }
+    scoreCoarse();
+}
+
+TLBOResult TLBO::run() {
+    std::unique_ptr<CheckpointWriter> checkpointer;
+    if (!params.checkpoint_path.empty()) {
+        checkpointer = std::make_unique<CheckpointWriter>(params.checkpoint_path);
+    }
+
+    if (checkpointer && checkpointExists(params.checkpoint_path)) {
+        restoreState(loadCheckpoint(params.checkpoint_path));
+    } else {
+        initialize();
+    }
+
+    while (!finished()) {
+        step();
+        if (checkpointer && params.checkpoint_interval != 0 && generation % params.checkpoint_interval == 0) {
+            checkpointer->submit(saveState());
+        }
+    }
+    if (checkpointer) {
+        checkpointer->submit(saveState());
+        checkpointer->flush();
+    }
+
+    return finish();
+}
+
+TLBOResult TLBO::finish() {
+    TLBOResult result;
+    const size_t best = subsampling() ? finalEvaluation(result.exact) : bestIndex();
+    result.best = population.row(best);
+    result.best_fitness = fitness[best];
+    result.generations = generation;
+    result.evaluations = evaluations;
+    result.abandoned = abandoned;
+    return result;
+}
@@ -0,0 +1,128 @@
+#ifndef TLBO_HPP
+#define TLBO_HPP
+
+#include <vector>
+#include <cstddef>
+#include <string>
+#include <memory>
+#include "objective_function.hpp"
+#include "checkpoint.hpp"
+#include "surrogate.hpp"
+#include "philox.hpp"
+#include "population.hpp"
+
+struct TLBOParams {
+    size_t population_size = 20;
+    size_t max_generations = 100;
+    size_t max_evaluations = 0;      // 0 — без ограничения
+    size_t stall_generations = 10;   // останов, если лучшее не улучшается столько поколений
+    double tolerance = 1e-6;         // минимальное улучшение, которое считается прогрессом
+    uint64_t seed = 42;
+    bool racing = false;             // досрочное отсечение предложений, не превосходящих текущих учеников
+    std::vector<double> lower;       // границы по каждому параметру
+    std::vector<double> upper;
+    std::string checkpoint_path;     // пусто — без контрольных точек
+    size_t checkpoint_interval = 1;  // поколений между контрольными точками
+    size_t surrogate_top_k = 0;      // 0 — без суррогата; иначе число предложений фазы для настоящей оценки
+    size_t surrogate_min_samples = 20;   // обучающих пар до включения отбора
+    size_t surrogate_capacity = 256;
+    double subsample_min_fraction = 1.0; // < 1 — оценка на растущей подвыборке пачек и атак
+    size_t subsample_final = 0;      // лучших кандидатов для итоговой полной оценки; 0 — вся популяция
+    int fidelity_level = 0;          // уровень пирамиды для отбора предложений; 0 — без отбора
+    size_t fidelity_generations = 0; // первых поколений с отбором на грубом уровне
+    size_t fidelity_promote = 0;     // предложений на полную оценку; 0 — все улучшившие на грубом уровне
+};
+
+struct TLBOResult {
+    Candidate best;
+    double best_fitness = 0.0;
+    size_t generations = 0;
+    size_t evaluations = 0;
+    size_t abandoned = 0;            // оценки, прерванные гонкой
+    bool exact = true;               // best_fitness получено на полном наборе пачек и атак
+};
+
+// Teaching-Learning-Based Optimization (максимизация целевой функции Optimizer).
+// Все кандидаты фазы вычисляются одним пакетом через Optimizer::evaluatePopulation.
+// При заданном checkpoint_path run() продолжает работу с существующей точки
+// и сохраняет новые в фоновом потоке.
+// При subsample_min_fraction < 1 каждое поколение оценивается на своей
+// подвыборке, доля которой растёт по мере схождения популяции; в конце
+// лучшие кандидаты переоцениваются на полном наборе.
+// При fidelity_level > 0 первые fidelity_generations поколений предложения
+// сначала оцениваются на уменьшенных изображениях, и до полного разрешения
+// доходят только улучшившие своего ученика на грубом уровне.
+class TLBO {
+public:
+    TLBO(Optimizer& optimizer, const TLBOParams& params);
+
+    TLBOResult run();
+
+    // Пошаговый интерфейс
+    void initialize();
+    void step();                     // одно поколение: фаза учителя + фаза ученика
+    bool finished() const;
+    TLBOResult finish();             // итоговая полная оценка (при подвыборке) и результат
+
+    // Снимок состояния (включая кэш Optimizer) и продолжение с него
+    TLBOState saveState() const;
+    void restoreState(const TLBOState& state);
+
+    // Замена худшего ученика пришедшим извне решением, если оно лучше;
+    // при подвыборке migrant_fitness не используется, мигрант оценивается заново
+    bool immigrate(const Candidate& migrant, double migrant_fitness);
+
+    size_t bestIndex() const;
+    const Population& getPopulation() const { return population; }
+    const std::vector<double>& getFitness() const { return fitness; }
+    size_t getGeneration() const { return generation; }
+    size_t getEvaluations() const { return evaluations; }
+    size_t getAbandoned() const { return abandoned; }
+    size_t getStall() const { return stall; }
+    double diversity() const;        // разброс популяции: 1 — как у равномерной, 0 — сошлась
+    double getSubsampleFraction() const { return subsample_fraction; }
+    size_t getCoarseEvaluations() const { return coarse_evaluations; }
+    const std::vector<SurrogateStats>& getSurrogateStats() const { return surrogate_stats; }
+
+private:
+    Optimizer& optimizer;
+    TLBOParams params;
+    CounterRNG rng;                  // случайные числа адресуются (поколение, особь, измерение)
+
+    Population population;           // структура массивов: столбец на измерение
+    std::vector<double> fitness;
+    Population proposals;
+    Population random;               // r для каждой пары (особь, измерение)
+    size_t dimensions = 0;
+    size_t generation = 0;
+    size_t evaluations = 0;
+    size_t abandoned = 0;
+    size_t stall = 0;
+    double best_so_far = 0.0;
+
+    std::unique_ptr<RBFSurrogate> surrogate;
+    std::vector<SurrogateStats> surrogate_stats;
+    std::vector<bool> exact;         // какие значения последней оценки точные (не границы гонки)
+
+    double subsample_fraction = 1.0; // текущая доля подвыборки; 1 — полный набор
+    Subsample subsample;
+
+    std::vector<double> coarse_fitness;  // значения учеников на уровне fidelity_level
+    size_t coarse_evaluations = 0;
+
+    void teacherPhase();
+    void learnerPhase();
+    std::vector<double> evaluate(const std::vector<Candidate>& candidates);
+    std::vector<double> evaluateProposals(const std::vector<Candidate>& proposals, const std::vector<double>& incumbents);
+    void fillRandom(RandomStream stream);
+    void screenAndAccept();
+    void acceptBetter(const std::vector<double>& proposal_fitness);
+    bool subsampling() const { return subsample_fraction < 1.0; }
+    void resample();
+    size_t finalEvaluation(bool& exact_best);
+    bool coarseScreening() const { return params.fidelity_level > 0 && generation < params.fidelity_generations; }
+    std::vector<double> evaluateCoarse(const std::vector<Candidate>& candidates);
+    void scoreCoarse();
+};
+
+#endif // TLBO_HPP
@@ -0,0 +1,130 @@
+#include "dispatch.hpp"
+#include "kernels.hpp"
+#include <atomic>
+#include <cstdlib>
+
+namespace simd {
+
+namespace {
+
+const Kernels SCALAR_KERNELS = {
+    Isa::SCALAR,
+    scalar::squared_error, scalar::byte_stats, scalar::cross_stats, scalar::window_sums,
+    scalar::block_sums, scalar::bit_stats, scalar::pack_bits,
+    scalar::moment_rows, scalar::filter_columns, scalar::ssim_map,
+    scalar::multiply4x4, scalar::transform8x8,
+    scalar::deinterleave_rgb, scalar::rgb_to_ycbcr, scalar::ycbcr_to_rgb,
+    scalar::pob, scalar::rev_pob,
+    scalar::sum, scalar::teacher_step, scalar::learner_step, scalar::clamp,
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+const Kernels AVX2_KERNELS = {
+    Isa::AVX2,
+    avx2::squared_error, avx2::byte_stats, avx2::cross_stats, avx2::window_sums,
+    avx2::block_sums, avx2::bit_stats, avx2::pack_bits,
+    avx2::moment_rows, avx2::filter_columns, avx2::ssim_map,
+    avx2::multiply4x4, avx2::transform8x8,
+    avx2::deinterleave_rgb, avx2::rgb_to_ycbcr, avx2::ycbcr_to_rgb,
+    avx2::pob, avx2::rev_pob,
+    avx2::sum, avx2::teacher_step, avx2::learner_step, avx2::clamp,
+};
+
+const Kernels AVX512_KERNELS = {
+    Isa::AVX512,
+    avx512::squared_error, avx512::byte_stats, avx512::cross_stats, avx2::window_sums,
+    avx2::block_sums, avx512::bit_stats, avx2::pack_bits,
+    avx2::moment_rows, avx2::filter_columns, avx2::ssim_map,
+    avx2::multiply4x4, avx2::transform8x8,
+    avx2::deinterleave_rgb, avx2::rgb_to_ycbcr, avx2::ycbcr_to_rgb,
+    avx2::pob, avx2::rev_pob,
+    avx2::sum, avx2::teacher_step, avx2::learner_step, avx2::clamp,
+};
+#endif
+
+const Kernels* table(Isa isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch (isa) {
+        case Isa::AVX512: return &AVX512_KERNELS;
+        case Isa::AVX2: return &AVX2_KERNELS;
+        default: break;
+    }
+#endif
+    (void)isa;
+    return &SCALAR_KERNELS;
+}
+
+Isa detect() {
+#if defined(__x86_64__) || defined(__i386__)
+    // __builtin_cpu_supports учитывает и поддержку регистров со стороны ОС (xgetbv)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+#endif
+    return Isa::SCALAR;
+}
+
+// Начальная таблица: лучшая доступная или заданная WM_SIMD, если она не выше доступной
+const Kernels* initial() {
+    Isa isa = detected_isa();
+    if (const char* forced = std::getenv("WM_SIMD")) {
+        Isa requested;
+        if (parse_isa(forced, requested) && requested <= isa) isa = requested;
+    }
+    return table(isa);
+}
+
+std::atomic<const Kernels*> active{nullptr};
+
+} // namespace
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+        default: return "unknown";
+    }
+}
+
+bool parse_isa(const std::string& name, Isa& isa) {
+    for (Isa candidate : {Isa::SCALAR, Isa::AVX2, Isa::AVX512}) {
+        if (name == isa_name(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+Isa detected_isa() {
+    static const Isa detected = detect();
+    return detected;
+}
+
+Isa active_isa() {
+    return kernels().isa;
+}
+
+bool set_isa(Isa isa) {
+    if (isa > detected_isa()) return false;
+    active.store(table(isa), std::memory_order_release);
+    return true;
+}
+
+void reset_isa() {
+    active.store(initial(), std::memory_order_release);
+}
+
+const Kernels& kernels() {
+    const Kernels* current = active.load(std::memory_order_acquire);
+    if (current == nullptr) {
+        // Гонка при первом обращении безвредна: все потоки получат одну таблицу
+        const Kernels* expected = nullptr;
+        current = initial();
+        if (!active.compare_exchange_strong(expected, current, std::memory_order_acq_rel)) current = expected;
+    }
+    return *current;
+}
+
+} // namespace simd
@@ -0,0 +1,109 @@
+#ifndef SIMD_DISPATCH_HPP
+#define SIMD_DISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Выбор векторных ядер во время выполнения. Для каждого набора инструкций
+// есть своя таблица указателей на функции; при первом обращении берётся
+// лучшая таблица, которую поддерживают процессор и ОС (cpuid + xgetbv),
+// поэтому один бинарный файл работает и на машинах без AVX2, и с AVX-512.
+// Остальной код собирается без -mavx2: векторные варианты включаются
+// атрибутами target только в файлах simd/kernels_*.cpp.
+//
+// Все варианты одного ядра дают побитово одинаковый результат: целочисленные
+// суммы точны, а в ядрах с плавающей точкой порядок операций совпадает со скалярным
+// и FMA не используется.
+namespace simd {
+
+enum class Isa : int {
+    SCALAR = 0,
+    AVX2,
+    AVX512,     // AVX-512F + AVX-512BW
+};
+
+const char* isa_name(Isa isa);
+bool parse_isa(const std::string& name, Isa& isa);   // "scalar", "avx2", "avx512"
+
+Isa detected_isa();   // лучший набор, доступный на этой машине
+Isa active_isa();     // набор текущей таблицы
+
+// Принудительный выбор, например для сравнения ядер в бенчмарке. Набор сверх
+// detected_isa() не включается: возвращается false и таблица не меняется.
+// При запуске то же можно задать переменной окружения WM_SIMD.
+bool set_isa(Isa isa);
+void reset_isa();  // к выбору при запуске, с учётом WM_SIMD
+
+// Целочисленные суммы окна SSIM: при 8-битных пикселях точны
+struct WindowSums {
+    int64_t x = 0, y = 0, xx = 0, yy = 0, xy = 0;
+};
+
+// Попарные суммы двух байтовых массивов: для NC и BER
+struct ByteStats {
+    int64_t ab = 0;               // Σ a·b
+    int64_t aa = 0;               // Σ a²
+    int64_t bb = 0;               // Σ b²
+    int64_t differing_bits = 0;   // Σ popcount(a ^ b)
+};
+
+// Попарные суммы двух битовых массивов: для упакованных ЦВЗ
+struct BitStats {
+    int64_t differing = 0;   // Σ popcount(a ^ b)
+    int64_t common = 0;      // Σ popcount(a & b)
+};
+
+struct Kernels {
+    Isa isa;
+
+    // Метрики
+    uint64_t (*squared_error)(const uint8_t* a, const uint8_t* b, size_t n);
+    ByteStats (*byte_stats)(const uint8_t* a, const uint8_t* b, size_t n);
+    // То же без Σ a² (aa = 0): для эталона с заранее посчитанной нормой
+    ByteStats (*cross_stats)(const uint8_t* a, const uint8_t* b, size_t n);
+    // Суммы count соседних окон 8x8, начиная с a и b; stride — длина строки
+    void (*window_sums)(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out);
+    // Суммы count соседних блоков 4x4 — для инкрементального пересчёта метрик
+    void (*block_sums)(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out);
+    BitStats (*bit_stats)(const uint64_t* a, const uint64_t* b, size_t words);
+    // Старшие биты n байт → биты слов: бит i слова w — байт 64·w + i. Хвост последнего слова нулевой
+    void (*pack_bits)(const uint8_t* bytes, size_t n, uint64_t* words);
+
+    // Сепарабельная свёртка float для гауссова SSIM (без выхода за край).
+    // Строка: m*[i] = Σ taps[k]·v[i + k] для v = x, y, x², y², xy, i < width.
+    void (*moment_rows)(const float* x, const float* y, size_t width, const float* taps, size_t count,
+                        float* mx, float* my, float* mxx, float* myy, float* mxy);
+    // Столбец: out[i] = Σ taps[k]·rows[k][i]
+    void (*filter_columns)(const float* const* rows, const float* taps, size_t count, size_t width, float* out);
+    // Карты SSIM и contrast-structure по отфильтрованным моментам
+    void (*ssim_map)(const float* mu1, const float* mu2, const float* exx, const float* eyy, const float* exy,
+                     size_t n, float c1, float c2, float* ssim, float* cs);
+
+    // Преобразования блоков (матрицы построчно)
+    void (*multiply4x4)(const double* m, const double* in, double* out);   // out = m · in (Адамар)
+    void (*transform8x8)(const double* m, double* block);                  // block = m · (block · m) (DCT)
+
+    // Цвет: n пикселей RGB (по байту) ↔ n троек Y, Cb, Cr (double)
+    void (*deinterleave_rgb)(const uint8_t* rgb, size_t n, uint8_t* r, uint8_t* g, uint8_t* b);
+    void (*rgb_to_ycbcr)(const uint8_t* rgb, double* ycbcr, size_t n);
+    void (*ycbcr_to_rgb)(const double* ycbcr, uint8_t* rgb, size_t n);
+
+    // POB по таблицам из WM.hpp: pixels — n пар (highBits, lowBits)
+    void (*pob)(uint8_t* pixels, uint8_t* key, size_t n);
+    void (*rev_pob)(uint8_t* pixels, const uint8_t* key, size_t n);
+
+    // Столбцы популяции TLBO
+    double (*sum)(const double* x, size_t n);
+    void (*teacher_step)(const double* x, const double* r, const double* tf, double teacher, double mean,
+                         double* out, size_t n);
+    void (*learner_step)(const double* x, const double* r, const double* direction, const int64_t* partner,
+                         double* out, size_t n);
+    void (*clamp)(double* x, double lower, double upper, size_t n);
+};
+
+const Kernels& kernels();
+
+} // namespace simd
+
+#endif // SIMD_DISPATCH_HPP
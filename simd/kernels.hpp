@@ -0,0 +1,67 @@
+#ifndef SIMD_KERNELS_HPP
+#define SIMD_KERNELS_HPP
+
+#include "dispatch.hpp"
+
+// Варианты ядер по наборам инструкций; собираются в таблицы в dispatch.cpp.
+// Вызывать их напрямую можно только после проверки процессора.
+namespace simd {
+
+#define SIMD_DECLARE_KERNELS                                                                                     \
+    uint64_t squared_error(const uint8_t* a, const uint8_t* b, size_t n);                                       \
+    ByteStats byte_stats(const uint8_t* a, const uint8_t* b, size_t n);                                         \
+    ByteStats cross_stats(const uint8_t* a, const uint8_t* b, size_t n);                                        \
+    void window_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out);         \
+    void block_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out);          \
+    BitStats bit_stats(const uint64_t* a, const uint64_t* b, size_t words);                                     \
+    void pack_bits(const uint8_t* bytes, size_t n, uint64_t* words);                                            \
+    void moment_rows(const float* x, const float* y, size_t width, const float* taps, size_t count,             \
+                     float* mx, float* my, float* mxx, float* myy, float* mxy);                                 \
+    void filter_columns(const float* const* rows, const float* taps, size_t count, size_t width, float* out);   \
+    void ssim_map(const float* mu1, const float* mu2, const float* exx, const float* eyy, const float* exy,      \
+                  size_t n, float c1, float c2, float* ssim, float* cs);                                        \
+    void multiply4x4(const double* m, const double* in, double* out);                                           \
+    void transform8x8(const double* m, double* block);                                                          \
+    void deinterleave_rgb(const uint8_t* rgb, size_t n, uint8_t* r, uint8_t* g, uint8_t* b);                   \
+    void rgb_to_ycbcr(const uint8_t* rgb, double* ycbcr, size_t n);                                             \
+    void ycbcr_to_rgb(const double* ycbcr, uint8_t* rgb, size_t n);                                             \
+    void pob(uint8_t* pixels, uint8_t* key, size_t n);                                                          \
+    void rev_pob(uint8_t* pixels, const uint8_t* key, size_t n);                                                \
+    double sum(const double* x, size_t n);                                                                      \
+    void teacher_step(const double* x, const double* r, const double* tf, double teacher, double mean,          \
+                      double* out, size_t n);                                                                   \
+    void learner_step(const double* x, const double* r, const double* direction, const int64_t* partner,        \
+                      double* out, size_t n);                                                                   \
+    void clamp(double* x, double lower, double upper, size_t n);
+
+namespace scalar {
+SIMD_DECLARE_KERNELS
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace avx2 {
+SIMD_DECLARE_KERNELS
+}
+
+// AVX-512 только там, где ширина даёт выигрыш; остальное берётся из avx2
+namespace avx512 {
+uint64_t squared_error(const uint8_t* a, const uint8_t* b, size_t n);
+ByteStats byte_stats(const uint8_t* a, const uint8_t* b, size_t n);
+ByteStats cross_stats(const uint8_t* a, const uint8_t* b, size_t n);
+BitStats bit_stats(const uint64_t* a, const uint64_t* b, size_t words);
+}
+#endif
+
+#undef SIMD_DECLARE_KERNELS
+
+// Суммирование по четырём частичным суммам, как в регистре из четырёх double:
+// скалярный и векторный sum() совпадают побитово
+constexpr size_t SUM_LANES = 4;
+
+// За итерацию векторного цикла в 32-битную ячейку добавляется не больше
+// 4·255², поэтому перенос в 64 бита нужен не чаще, чем раз в 4096 итераций
+constexpr size_t FLUSH_ITERATIONS = 4096;
+
+} // namespace simd
+
+#endif // SIMD_KERNELS_HPP
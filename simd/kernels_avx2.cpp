@@ -0,0 +1,598 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cstring>
+#include <immintrin.h>
+#include "WM/WM.hpp"
+
+// Только для функций этого файла; FMA не включается, чтобы результаты
+// совпадали со скалярными побитово
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace simd::avx2 {
+
+namespace {
+
+int64_t hsum_epi32(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+int64_t hsum_epi64(__m256i v) {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// 32-битные частичные суммы → 64-битный накопитель
+__m256i widen_add(__m256i total, __m256i partial) {
+    const __m256i zero = _mm256_setzero_si256();
+    total = _mm256_add_epi64(total, _mm256_unpacklo_epi32(partial, zero));
+    return _mm256_add_epi64(total, _mm256_unpackhi_epi32(partial, zero));
+}
+
+__m256i lut16(const uint8_t* table) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// Два соседних окна 8x8 за раз: строка из 16 пикселей расширяется до 16 бит,
+// нижняя половина регистра относится к левому окну, верхняя — к правому
+void window_pair_sums(const uint8_t* p1, const uint8_t* p2, size_t stride, WindowSums& left, WindowSums& right) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sx = _mm256_setzero_si256(), sy = _mm256_setzero_si256();
+    __m256i sxx = _mm256_setzero_si256(), syy = _mm256_setzero_si256(), sxy = _mm256_setzero_si256();
+
+    for (size_t dy = 0; dy < 8; ++dy) {
+        const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + dy * stride)));
+        const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p2 + dy * stride)));
+
+        sx = _mm256_add_epi32(sx, _mm256_madd_epi16(a, ones));
+        sy = _mm256_add_epi32(sy, _mm256_madd_epi16(b, ones));
+        sxx = _mm256_add_epi32(sxx, _mm256_madd_epi16(a, a));
+        syy = _mm256_add_epi32(syy, _mm256_madd_epi16(b, b));
+        sxy = _mm256_add_epi32(sxy, _mm256_madd_epi16(a, b));
+    }
+
+    auto split = [](__m256i v, int64_t& low, int64_t& high) {
+        low = hsum_epi32(_mm256_castsi256_si128(v));
+        high = hsum_epi32(_mm256_extracti128_si256(v, 1));
+    };
+    split(sx, left.x, right.x);
+    split(sy, left.y, right.y);
+    split(sxx, left.xx, right.xx);
+    split(syy, left.yy, right.yy);
+    split(sxy, left.xy, right.xy);
+}
+
+// Один блок 4x4; строки собираются в регистре: запись на стек и чтение
+// 16 байт сорвали бы store forwarding
+void single_block_sums(const uint8_t* a, const uint8_t* b, size_t stride, WindowSums& out) {
+    auto load_block = [stride](const uint8_t* p) {
+        auto row = [&](size_t dy) {
+            int32_t value;
+            std::memcpy(&value, p + dy * stride, 4);
+            return value;
+        };
+        __m128i rows = _mm_cvtsi32_si128(row(0));
+        rows = _mm_insert_epi32(rows, row(1), 1);
+        rows = _mm_insert_epi32(rows, row(2), 2);
+        rows = _mm_insert_epi32(rows, row(3), 3);
+        return _mm256_cvtepu8_epi16(rows);
+    };
+    const __m256i va = load_block(a), vb = load_block(b);
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    // hadd сводит четыре вектора сумм к одному: x, y, xx, yy в каждой половине
+    const __m256i linear = _mm256_hadd_epi32(_mm256_madd_epi16(va, ones), _mm256_madd_epi16(vb, ones));
+    const __m256i squares = _mm256_hadd_epi32(_mm256_madd_epi16(va, va), _mm256_madd_epi16(vb, vb));
+    const __m256i moments = _mm256_hadd_epi32(linear, squares);
+    const __m128i total = _mm_add_epi32(_mm256_castsi256_si128(moments), _mm256_extracti128_si256(moments, 1));
+    const __m256i cross = _mm256_madd_epi16(va, vb);
+
+    out.x = _mm_extract_epi32(total, 0);
+    out.y = _mm_extract_epi32(total, 1);
+    out.xx = _mm_extract_epi32(total, 2);
+    out.yy = _mm_extract_epi32(total, 3);
+    out.xy = hsum_epi32(_mm_add_epi32(_mm256_castsi256_si128(cross), _mm256_extracti128_si256(cross, 1)));
+}
+
+} // namespace
+
+uint64_t squared_error(const uint8_t* a, const uint8_t* b, size_t n) {
+    constexpr size_t step = 32;
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + step <= n) {
+        __m256i partial = _mm256_setzero_si256();
+        for (size_t k = 0; k < FLUSH_ITERATIONS && i + step <= n; ++k, i += step) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+
+            const __m256i low = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(va)),
+                                                 _mm256_cvtepu8_epi16(_mm256_castsi256_si128(vb)));
+            const __m256i high = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(va, 1)),
+                                                  _mm256_cvtepu8_epi16(_mm256_extracti128_si256(vb, 1)));
+
+            partial = _mm256_add_epi32(partial, _mm256_madd_epi16(low, low));
+            partial = _mm256_add_epi32(partial, _mm256_madd_epi16(high, high));
+        }
+        total = widen_add(total, partial);
+    }
+
+    return hsum_epi64(total) + scalar::squared_error(a + i, b + i, n - i);
+}
+
+namespace {
+
+template <bool with_aa>
+ByteStats pair_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    constexpr size_t step = 32;
+    // popcount байта — по таблице для каждого полубайта
+    const __m256i nibble_popcount = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i ab = _mm256_setzero_si256(), aa = _mm256_setzero_si256(), bb = _mm256_setzero_si256();
+    __m256i bits = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + step <= n) {
+        __m256i ab32 = _mm256_setzero_si256(), aa32 = _mm256_setzero_si256(), bb32 = _mm256_setzero_si256();
+        for (size_t k = 0; k < FLUSH_ITERATIONS && i + step <= n; ++k, i += step) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+
+            const __m256i x = _mm256_xor_si256(va, vb);
+            const __m256i count = _mm256_add_epi8(
+                _mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(x, low_mask)),
+                _mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask)));
+            bits = _mm256_add_epi64(bits, _mm256_sad_epu8(count, _mm256_setzero_si256()));
+
+            const __m256i a_lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(va));
+            const __m256i a_hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(va, 1));
+            const __m256i b_lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(vb));
+            const __m256i b_hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(vb, 1));
+
+            ab32 = _mm256_add_epi32(ab32, _mm256_add_epi32(_mm256_madd_epi16(a_lo, b_lo), _mm256_madd_epi16(a_hi, b_hi)));
+            if constexpr (with_aa) {
+                aa32 = _mm256_add_epi32(aa32, _mm256_add_epi32(_mm256_madd_epi16(a_lo, a_lo), _mm256_madd_epi16(a_hi, a_hi)));
+            }
+            bb32 = _mm256_add_epi32(bb32, _mm256_add_epi32(_mm256_madd_epi16(b_lo, b_lo), _mm256_madd_epi16(b_hi, b_hi)));
+        }
+        ab = widen_add(ab, ab32);
+        aa = widen_add(aa, aa32);
+        bb = widen_add(bb, bb32);
+    }
+
+    ByteStats stats = with_aa ? scalar::byte_stats(a + i, b + i, n - i) : scalar::cross_stats(a + i, b + i, n - i);
+    stats.ab += hsum_epi64(ab);
+    stats.aa += hsum_epi64(aa);
+    stats.bb += hsum_epi64(bb);
+    stats.differing_bits += hsum_epi64(bits);
+    return stats;
+}
+
+} // namespace
+
+ByteStats byte_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<true>(a, b, n);
+}
+
+ByteStats cross_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<false>(a, b, n);
+}
+
+void window_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out) {
+    size_t w = 0;
+    for (; w + 1 < count; w += 2) {
+        window_pair_sums(a + w * 8, b + w * 8, stride, out[w], out[w + 1]);
+    }
+    scalar::window_sums(a + w * 8, b + w * 8, stride, count - w, out + w);
+}
+
+void block_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    size_t k = 0;
+
+    // Четыре блока за раз: строка из 16 пикселей, пары 32-битных сумм на блок
+    for (; k + 4 <= count; k += 4) {
+        __m256i sx = _mm256_setzero_si256(), sy = _mm256_setzero_si256();
+        __m256i sxx = _mm256_setzero_si256(), syy = _mm256_setzero_si256(), sxy = _mm256_setzero_si256();
+        for (size_t dy = 0; dy < 4; ++dy) {
+            const __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + dy * stride + k * 4)));
+            const __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + dy * stride + k * 4)));
+            sx = _mm256_add_epi32(sx, _mm256_madd_epi16(va, ones));
+            sy = _mm256_add_epi32(sy, _mm256_madd_epi16(vb, ones));
+            sxx = _mm256_add_epi32(sxx, _mm256_madd_epi16(va, va));
+            syy = _mm256_add_epi32(syy, _mm256_madd_epi16(vb, vb));
+            sxy = _mm256_add_epi32(sxy, _mm256_madd_epi16(va, vb));
+        }
+
+        // hadd складывает пары: в половине регистра — блоки k, k+1 (нижняя) или k+2, k+3
+        alignas(32) int32_t first[8], second[8], cross[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(first), _mm256_hadd_epi32(sx, sy));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(second), _mm256_hadd_epi32(sxx, syy));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(cross), _mm256_hadd_epi32(sxy, sxy));
+        for (size_t j = 0; j < 4; ++j) {
+            const size_t lane = (j / 2) * 4 + j % 2;
+            out[k + j].x = first[lane];
+            out[k + j].y = first[lane + 2];
+            out[k + j].xx = second[lane];
+            out[k + j].yy = second[lane + 2];
+            out[k + j].xy = cross[lane];
+        }
+    }
+
+    for (; k < count; ++k) {
+        single_block_sums(a + k * 4, b + k * 4, stride, out[k]);
+    }
+}
+
+BitStats bit_stats(const uint64_t* a, const uint64_t* b, size_t words) {
+    constexpr size_t step = 4;
+    const __m256i nibble_popcount = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    // popcount каждого байта, суммы по восьмёркам байт — в 64-битных ячейках
+    auto popcount = [&](__m256i x) {
+        const __m256i count = _mm256_add_epi8(
+            _mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(x, low_mask)),
+            _mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask)));
+        return _mm256_sad_epu8(count, _mm256_setzero_si256());
+    };
+
+    __m256i differing = _mm256_setzero_si256(), common = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + step <= words; i += step) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        differing = _mm256_add_epi64(differing, popcount(_mm256_xor_si256(va, vb)));
+        common = _mm256_add_epi64(common, popcount(_mm256_and_si256(va, vb)));
+    }
+
+    BitStats stats = scalar::bit_stats(a + i, b + i, words - i);
+    stats.differing += hsum_epi64(differing);
+    stats.common += hsum_epi64(common);
+    return stats;
+}
+
+void pack_bits(const uint8_t* bytes, size_t n, uint64_t* words) {
+    size_t w = 0;
+    for (; (w + 1) * 64 <= n; ++w) {
+        // movemask собирает как раз старшие биты байт
+        const uint32_t low = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + w * 64))));
+        const uint32_t high = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + w * 64 + 32))));
+        words[w] = (static_cast<uint64_t>(high) << 32) | low;
+    }
+    scalar::pack_bits(bytes + w * 64, n - w * 64, words + w);
+}
+
+void moment_rows(const float* x, const float* y, size_t width, const float* taps, size_t count,
+                 float* mx, float* my, float* mxx, float* myy, float* mxy) {
+    size_t i = 0;
+    for (; i + 8 <= width; i += 8) {
+        __m256 sx = _mm256_setzero_ps(), sy = _mm256_setzero_ps();
+        __m256 sxx = _mm256_setzero_ps(), syy = _mm256_setzero_ps(), sxy = _mm256_setzero_ps();
+        for (size_t k = 0; k < count; ++k) {
+            const __m256 a = _mm256_loadu_ps(x + i + k);
+            const __m256 b = _mm256_loadu_ps(y + i + k);
+            const __m256 t = _mm256_set1_ps(taps[k]);
+            sx = _mm256_add_ps(sx, _mm256_mul_ps(t, a));
+            sy = _mm256_add_ps(sy, _mm256_mul_ps(t, b));
+            sxx = _mm256_add_ps(sxx, _mm256_mul_ps(t, _mm256_mul_ps(a, a)));
+            syy = _mm256_add_ps(syy, _mm256_mul_ps(t, _mm256_mul_ps(b, b)));
+            sxy = _mm256_add_ps(sxy, _mm256_mul_ps(t, _mm256_mul_ps(a, b)));
+        }
+        _mm256_storeu_ps(mx + i, sx);
+        _mm256_storeu_ps(my + i, sy);
+        _mm256_storeu_ps(mxx + i, sxx);
+        _mm256_storeu_ps(myy + i, syy);
+        _mm256_storeu_ps(mxy + i, sxy);
+    }
+    scalar::moment_rows(x + i, y + i, width - i, taps, count, mx + i, my + i, mxx + i, myy + i, mxy + i);
+}
+
+void filter_columns(const float* const* rows, const float* taps, size_t count, size_t width, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= width; i += 8) {
+        __m256 total = _mm256_setzero_ps();
+        for (size_t k = 0; k < count; ++k) {
+            total = _mm256_add_ps(total, _mm256_mul_ps(_mm256_set1_ps(taps[k]), _mm256_loadu_ps(rows[k] + i)));
+        }
+        _mm256_storeu_ps(out + i, total);
+    }
+    for (; i < width; ++i) {
+        float total = 0.0f;
+        for (size_t k = 0; k < count; ++k) {
+            total += taps[k] * rows[k][i];
+        }
+        out[i] = total;
+    }
+}
+
+void ssim_map(const float* mu1, const float* mu2, const float* exx, const float* eyy, const float* exy,
+              size_t n, float c1, float c2, float* ssim, float* cs) {
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 vc1 = _mm256_set1_ps(c1);
+    const __m256 vc2 = _mm256_set1_ps(c2);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 a = _mm256_loadu_ps(mu1 + i);
+        const __m256 b = _mm256_loadu_ps(mu2 + i);
+        const __m256 m11 = _mm256_mul_ps(a, a), m22 = _mm256_mul_ps(b, b), m12 = _mm256_mul_ps(a, b);
+
+        const __m256 contrast = _mm256_div_ps(
+            _mm256_add_ps(_mm256_mul_ps(two, _mm256_sub_ps(_mm256_loadu_ps(exy + i), m12)), vc2),
+            _mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_loadu_ps(exx + i), m11),
+                                        _mm256_sub_ps(_mm256_loadu_ps(eyy + i), m22)), vc2));
+        const __m256 luminance = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(two, m12), vc1),
+                                               _mm256_add_ps(_mm256_add_ps(m11, m22), vc1));
+        _mm256_storeu_ps(cs + i, contrast);
+        _mm256_storeu_ps(ssim + i, _mm256_mul_ps(luminance, contrast));
+    }
+    scalar::ssim_map(mu1 + i, mu2 + i, exx + i, eyy + i, exy + i, n - i, c1, c2, ssim + i, cs + i);
+}
+
+void multiply4x4(const double* m, const double* in, double* out) {
+    const __m256d rows[4] = {_mm256_loadu_pd(in), _mm256_loadu_pd(in + 4), _mm256_loadu_pd(in + 8),
+                             _mm256_loadu_pd(in + 12)};
+    for (int i = 0; i < 4; ++i) {
+        __m256d total = _mm256_setzero_pd();
+        for (int k = 0; k < 4; ++k) {
+            total = _mm256_add_pd(total, _mm256_mul_pd(_mm256_set1_pd(m[i * 4 + k]), rows[k]));
+        }
+        _mm256_storeu_pd(out + i * 4, total);
+    }
+}
+
+void transform8x8(const double* m, double* block) {
+    // Строка i произведения a · b — сумма строк b с весами a[i][k]
+    auto multiply = [](const double* a, const double* b, double* out) {
+        for (int i = 0; i < 8; ++i) {
+            __m256d left = _mm256_setzero_pd(), right = _mm256_setzero_pd();
+            for (int k = 0; k < 8; ++k) {
+                const __m256d weight = _mm256_set1_pd(a[i * 8 + k]);
+                left = _mm256_add_pd(left, _mm256_mul_pd(weight, _mm256_loadu_pd(b + k * 8)));
+                right = _mm256_add_pd(right, _mm256_mul_pd(weight, _mm256_loadu_pd(b + k * 8 + 4)));
+            }
+            _mm256_storeu_pd(out + i * 8, left);
+            _mm256_storeu_pd(out + i * 8 + 4, right);
+        }
+    };
+
+    double temp[64];
+    multiply(block, m, temp);
+    multiply(m, temp, block);
+}
+
+void deinterleave_rgb(const uint8_t* rgb, size_t n, uint8_t* r, uint8_t* g, uint8_t* b) {
+    // 16 пикселей — три регистра по 16 байт; каждый канал собирается из трёх
+    // pshufb (-1 обнуляет байт) и двух or
+    const __m128i r0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i b0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i + 16));
+        const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i + 32));
+
+        auto gather = [&](__m128i m0, __m128i m1, __m128i m2) {
+            return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m0), _mm_shuffle_epi8(a1, m1)),
+                                _mm_shuffle_epi8(a2, m2));
+        };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), gather(r0, r1, r2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(g + i), gather(g0, g1, g2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), gather(b0, b1, b2));
+    }
+    scalar::deinterleave_rgb(rgb + 3 * i, n - i, r + i, g + i, b + i);
+}
+
+void rgb_to_ycbcr(const uint8_t* rgb, double* ycbcr, size_t n) {
+    // 12 байт четырёх пикселей → r0..r3, g0..g3, b0..b3
+    const __m128i planar = _mm_setr_epi8(0, 3, 6, 9, 1, 4, 7, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+    const __m256d c128 = _mm256_set1_pd(128.0);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        int32_t tail;
+        std::memcpy(&tail, rgb + 3 * i + 8, sizeof(tail));
+        const __m128i bytes = _mm_shuffle_epi8(
+            _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rgb + 3 * i)), _mm_cvtsi32_si128(tail)),
+            planar);
+
+        const __m256d r = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(bytes));
+        const __m256d g = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4)));
+        const __m256d b = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+
+        const __m256d y = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(0.299), r),
+                                                      _mm256_mul_pd(_mm256_set1_pd(0.587), g)),
+                                        _mm256_mul_pd(_mm256_set1_pd(0.114), b));
+        const __m256d cb = _mm256_add_pd(c128, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(-0.168736), r),
+                                                                           _mm256_mul_pd(_mm256_set1_pd(0.331264), g)),
+                                                             _mm256_mul_pd(_mm256_set1_pd(0.5), b)));
+        const __m256d cr = _mm256_add_pd(c128, _mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), r),
+                                                                           _mm256_mul_pd(_mm256_set1_pd(0.418688), g)),
+                                                             _mm256_mul_pd(_mm256_set1_pd(0.081312), b)));
+
+        // Обратно к тройкам: [y0 cb0 cr0 y1] [cb1 cr1 y2 cb2] [cr2 y3 cb3 cr3]
+        __m256d out0 = _mm256_blend_pd(_mm256_permute4x64_pd(y, 0x40), _mm256_permute4x64_pd(cb, 0x00), 0b0010);
+        out0 = _mm256_blend_pd(out0, _mm256_permute4x64_pd(cr, 0x00), 0b0100);
+        __m256d out1 = _mm256_blend_pd(_mm256_permute4x64_pd(cb, 0x95), _mm256_permute4x64_pd(cr, 0x55), 0b0010);
+        out1 = _mm256_blend_pd(out1, _mm256_permute4x64_pd(y, 0xAA), 0b0100);
+        __m256d out2 = _mm256_blend_pd(_mm256_permute4x64_pd(cr, 0xEA), _mm256_permute4x64_pd(y, 0xFF), 0b0010);
+        out2 = _mm256_blend_pd(out2, _mm256_permute4x64_pd(cb, 0xFF), 0b0100);
+
+        _mm256_storeu_pd(ycbcr + 3 * i, out0);
+        _mm256_storeu_pd(ycbcr + 3 * i + 4, out1);
+        _mm256_storeu_pd(ycbcr + 3 * i + 8, out2);
+    }
+
+    scalar::rgb_to_ycbcr(rgb + 3 * i, ycbcr + 3 * i, n - i);
+}
+
+void ycbcr_to_rgb(const double* ycbcr, uint8_t* rgb, size_t n) {
+    // Байты r, g, b из четырёх 32-битных ячеек подряд
+    const __m128i packed = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256d c128 = _mm256_set1_pd(128.0);
+    const __m256d c255 = _mm256_set1_pd(255.0);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+
+    auto to_bytes = [&](__m256d v) {
+        return _mm256_cvttpd_epi32(_mm256_max_pd(_mm256_min_pd(v, c255), zero));
+    };
+
+    for (; i + 4 <= n; i += 4) {
+        const __m256d in0 = _mm256_loadu_pd(ycbcr + 3 * i);
+        const __m256d in1 = _mm256_loadu_pd(ycbcr + 3 * i + 4);
+        const __m256d in2 = _mm256_loadu_pd(ycbcr + 3 * i + 8);
+
+        const __m256d y = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(in0, in1, 0b0100), in2, 0b0010), 0x6C);
+        const __m256d cb = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(in0, in1, 0b1001), in2, 0b0100), 0xB1);
+        const __m256d cr = _mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(in0, in1, 0b0010), in2, 0b1001), 0xC6);
+
+        const __m256d cb0 = _mm256_sub_pd(cb, c128);
+        const __m256d cr0 = _mm256_sub_pd(cr, c128);
+        const __m128i r = to_bytes(_mm256_add_pd(y, _mm256_mul_pd(_mm256_set1_pd(1.402), cr0)));
+        const __m128i g = to_bytes(_mm256_sub_pd(_mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(0.344136), cb0)),
+                                                 _mm256_mul_pd(_mm256_set1_pd(0.714136), cr0)));
+        const __m128i b = to_bytes(_mm256_add_pd(y, _mm256_mul_pd(_mm256_set1_pd(1.772), cb0)));
+
+        const __m128i pixels = _mm_shuffle_epi8(
+            _mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(b, 16))), packed);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(rgb + 3 * i), pixels);
+        const int32_t tail = _mm_extract_epi32(pixels, 2);
+        std::memcpy(rgb + 3 * i + 8, &tail, sizeof(tail));
+    }
+
+    scalar::ycbcr_to_rgb(ycbcr + 3 * i, rgb + 3 * i, n - i);
+}
+
+void pob(uint8_t* pixels, uint8_t* key, size_t n) {
+    const __m256i low_bits_lut = lut16(LOW_BITS_LUT);
+    const __m256i r_lut = lut16(R_LUT);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i odd = _mm256_set1_epi16(static_cast<short>(0xff00));   // байты lowBits
+    size_t i = 0;
+
+    // 16 пар (highBits, lowBits) за итерацию
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + 2 * i));
+        const __m256i low = _mm256_and_si256(v, low_mask);
+
+        const __m256i replaced = _mm256_blendv_epi8(v, _mm256_shuffle_epi8(low_bits_lut, low), odd);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + 2 * i), replaced);
+
+        const __m256i keys = _mm256_srli_epi16(_mm256_shuffle_epi8(r_lut, low), 8);
+        const __m256i compact = _mm256_permute4x64_epi64(_mm256_packus_epi16(keys, keys), 0b1000);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(key + i), _mm256_castsi256_si128(compact));
+    }
+
+    scalar::pob(pixels + 2 * i, key + i, n - i);
+}
+
+void rev_pob(uint8_t* pixels, const uint8_t* key, size_t n) {
+    // REV_LOW_BITS_LUT[k][low] по индексу 4k + low: 0..15 и 16..19
+    uint8_t table[32] = {};
+    for (int k = 0; k < 5; ++k) {
+        for (int low = 0; low < 4; ++low) {
+            table[4 * k + low] = REV_LOW_BITS_LUT[k][low];
+        }
+    }
+    const __m256i first = lut16(table);
+    const __m256i second = lut16(table + 16);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i odd = _mm256_set1_epi16(static_cast<short>(0xff00));
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + 2 * i));
+        const __m256i k = _mm256_slli_epi16(
+            _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key + i))), 8);
+
+        const __m256i valid = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(k, _mm256_set1_epi8(4)), k),
+                                               _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(3)), v));
+        const __m256i k4 = _mm256_add_epi8(k, k);
+        const __m256i index = _mm256_add_epi8(_mm256_add_epi8(k4, k4), v);
+        const __m256i nibble = _mm256_and_si256(index, low_mask);
+
+        __m256i restored = _mm256_blendv_epi8(_mm256_shuffle_epi8(first, nibble), _mm256_shuffle_epi8(second, nibble),
+                                              _mm256_cmpgt_epi8(index, _mm256_set1_epi8(15)));
+        restored = _mm256_and_si256(restored, valid);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + 2 * i), _mm256_blendv_epi8(v, restored, odd));
+    }
+
+    scalar::rev_pob(pixels + 2 * i, key + i, n - i);
+}
+
+double sum(const double* x, size_t n) {
+    __m256d total = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+        total = _mm256_add_pd(total, _mm256_loadu_pd(x + i));
+    }
+
+    double lanes[SUM_LANES];
+    _mm256_storeu_pd(lanes, total);
+    double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) {
+        result += x[i];
+    }
+    return result;
+}
+
+void teacher_step(const double* x, const double* r, const double* tf, double teacher, double mean,
+                  double* out, size_t n) {
+    const __m256d t = _mm256_set1_pd(teacher);
+    const __m256d m = _mm256_set1_pd(mean);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d step = _mm256_sub_pd(t, _mm256_mul_pd(_mm256_loadu_pd(tf + i), m));
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_mul_pd(_mm256_loadu_pd(r + i), step)));
+    }
+    scalar::teacher_step(x + i, r + i, tf + i, teacher, mean, out + i, n - i);
+}
+
+void learner_step(const double* x, const double* r, const double* direction, const int64_t* partner,
+                  double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(partner + i));
+        const __m256d xj = _mm256_i64gather_pd(x, idx, 8);
+        const __m256d xi = _mm256_loadu_pd(x + i);
+        const __m256d scale = _mm256_mul_pd(_mm256_loadu_pd(r + i), _mm256_loadu_pd(direction + i));
+        _mm256_storeu_pd(out + i, _mm256_add_pd(xi, _mm256_mul_pd(scale, _mm256_sub_pd(xi, xj))));
+    }
+    // Хвост индексирует весь столбец x через partner, поэтому без сдвига указателей
+    for (; i < n; ++i) {
+        out[i] = x[i] + r[i] * direction[i] * (x[i] - x[partner[i]]);
+    }
+}
+
+void clamp(double* x, double lower, double upper, size_t n) {
+    const __m256d lo = _mm256_set1_pd(lower);
+    const __m256d hi = _mm256_set1_pd(upper);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(x + i, _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(x + i), lo), hi));
+    }
+    scalar::clamp(x + i, lower, upper, n - i);
+}
+
+} // namespace simd::avx2
+
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,132 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2,avx512f,avx512bw")
+// Заголовки GCC 12 дают ложные предупреждения о _mm512_undefined_* вне -mavx512f
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+namespace simd::avx512 {
+
+namespace {
+
+__m512i widen_add(__m512i total, __m512i partial) {
+    const __m512i zero = _mm512_setzero_si512();
+    total = _mm512_add_epi64(total, _mm512_unpacklo_epi32(partial, zero));
+    return _mm512_add_epi64(total, _mm512_unpackhi_epi32(partial, zero));
+}
+
+__m512i load_wide(const uint8_t* p) {
+    return _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+} // namespace
+
+uint64_t squared_error(const uint8_t* a, const uint8_t* b, size_t n) {
+    constexpr size_t step = 64;
+    __m512i total = _mm512_setzero_si512();
+    size_t i = 0;
+
+    while (i + step <= n) {
+        __m512i partial = _mm512_setzero_si512();
+        for (size_t k = 0; k < FLUSH_ITERATIONS && i + step <= n; ++k, i += step) {
+            const __m512i low = _mm512_sub_epi16(load_wide(a + i), load_wide(b + i));
+            const __m512i high = _mm512_sub_epi16(load_wide(a + i + 32), load_wide(b + i + 32));
+
+            partial = _mm512_add_epi32(partial, _mm512_madd_epi16(low, low));
+            partial = _mm512_add_epi32(partial, _mm512_madd_epi16(high, high));
+        }
+        total = widen_add(total, partial);
+    }
+
+    return static_cast<uint64_t>(_mm512_reduce_add_epi64(total)) + avx2::squared_error(a + i, b + i, n - i);
+}
+
+namespace {
+
+template <bool with_aa>
+ByteStats pair_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    constexpr size_t step = 64;
+    const __m512i nibble_popcount = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low_mask = _mm512_set1_epi8(0x0f);
+    __m512i ab = _mm512_setzero_si512(), aa = _mm512_setzero_si512(), bb = _mm512_setzero_si512();
+    __m512i bits = _mm512_setzero_si512();
+    size_t i = 0;
+
+    while (i + step <= n) {
+        __m512i ab32 = _mm512_setzero_si512(), aa32 = _mm512_setzero_si512(), bb32 = _mm512_setzero_si512();
+        for (size_t k = 0; k < FLUSH_ITERATIONS && i + step <= n; ++k, i += step) {
+            const __m512i x = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+            const __m512i count = _mm512_add_epi8(
+                _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(x, low_mask)),
+                _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(_mm512_srli_epi16(x, 4), low_mask)));
+            bits = _mm512_add_epi64(bits, _mm512_sad_epu8(count, _mm512_setzero_si512()));
+
+            const __m512i a_lo = load_wide(a + i), a_hi = load_wide(a + i + 32);
+            const __m512i b_lo = load_wide(b + i), b_hi = load_wide(b + i + 32);
+
+            ab32 = _mm512_add_epi32(ab32, _mm512_add_epi32(_mm512_madd_epi16(a_lo, b_lo), _mm512_madd_epi16(a_hi, b_hi)));
+            if constexpr (with_aa) {
+                aa32 = _mm512_add_epi32(aa32, _mm512_add_epi32(_mm512_madd_epi16(a_lo, a_lo), _mm512_madd_epi16(a_hi, a_hi)));
+            }
+            bb32 = _mm512_add_epi32(bb32, _mm512_add_epi32(_mm512_madd_epi16(b_lo, b_lo), _mm512_madd_epi16(b_hi, b_hi)));
+        }
+        ab = widen_add(ab, ab32);
+        aa = widen_add(aa, aa32);
+        bb = widen_add(bb, bb32);
+    }
+
+    ByteStats stats = with_aa ? avx2::byte_stats(a + i, b + i, n - i) : avx2::cross_stats(a + i, b + i, n - i);
+    stats.ab += _mm512_reduce_add_epi64(ab);
+    stats.aa += _mm512_reduce_add_epi64(aa);
+    stats.bb += _mm512_reduce_add_epi64(bb);
+    stats.differing_bits += _mm512_reduce_add_epi64(bits);
+    return stats;
+}
+
+} // namespace
+
+ByteStats byte_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<true>(a, b, n);
+}
+
+ByteStats cross_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<false>(a, b, n);
+}
+
+BitStats bit_stats(const uint64_t* a, const uint64_t* b, size_t words) {
+    constexpr size_t step = 8;
+    const __m512i nibble_popcount = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low_mask = _mm512_set1_epi8(0x0f);
+    auto popcount = [&](__m512i x) {
+        const __m512i count = _mm512_add_epi8(
+            _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(x, low_mask)),
+            _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(_mm512_srli_epi16(x, 4), low_mask)));
+        return _mm512_sad_epu8(count, _mm512_setzero_si512());
+    };
+
+    __m512i differing = _mm512_setzero_si512(), common = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + step <= words; i += step) {
+        const __m512i va = _mm512_loadu_si512(a + i);
+        const __m512i vb = _mm512_loadu_si512(b + i);
+        differing = _mm512_add_epi64(differing, popcount(_mm512_xor_si512(va, vb)));
+        common = _mm512_add_epi64(common, popcount(_mm512_and_si512(va, vb)));
+    }
+
+    BitStats stats = avx2::bit_stats(a + i, b + i, words - i);
+    stats.differing += _mm512_reduce_add_epi64(differing);
+    stats.common += _mm512_reduce_add_epi64(common);
+    return stats;
+}
+
+} // namespace simd::avx512
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,255 @@
+#include "kernels.hpp"
+#include "WM/WM.hpp"
+#include <algorithm>
+
+namespace simd::scalar {
+
+uint64_t squared_error(const uint8_t* a, const uint8_t* b, size_t n) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const int diff = a[i] - b[i];
+        total += static_cast<uint32_t>(diff * diff);
+    }
+    return total;
+}
+
+namespace {
+
+template <bool with_aa>
+ByteStats pair_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    ByteStats stats;
+    for (size_t i = 0; i < n; ++i) {
+        const int x = a[i];
+        const int y = b[i];
+        stats.ab += x * y;
+        if constexpr (with_aa) stats.aa += x * x;
+        stats.bb += y * y;
+        stats.differing_bits += __builtin_popcount(static_cast<unsigned>(x ^ y));
+    }
+    return stats;
+}
+
+} // namespace
+
+ByteStats byte_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<true>(a, b, n);
+}
+
+ByteStats cross_stats(const uint8_t* a, const uint8_t* b, size_t n) {
+    return pair_stats<false>(a, b, n);
+}
+
+void window_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out) {
+    for (size_t w = 0; w < count; ++w) {
+        WindowSums sums;
+        for (size_t dy = 0; dy < 8; ++dy) {
+            const uint8_t* row1 = a + dy * stride + w * 8;
+            const uint8_t* row2 = b + dy * stride + w * 8;
+            for (size_t dx = 0; dx < 8; ++dx) {
+                const int x = row1[dx];
+                const int y = row2[dx];
+                sums.x += x;
+                sums.y += y;
+                sums.xx += x * x;
+                sums.yy += y * y;
+                sums.xy += x * y;
+            }
+        }
+        out[w] = sums;
+    }
+}
+
+void block_sums(const uint8_t* a, const uint8_t* b, size_t stride, size_t count, WindowSums* out) {
+    for (size_t k = 0; k < count; ++k) {
+        WindowSums sums;
+        for (size_t dy = 0; dy < 4; ++dy) {
+            for (size_t dx = 0; dx < 4; ++dx) {
+                const int x = a[dy * stride + k * 4 + dx];
+                const int y = b[dy * stride + k * 4 + dx];
+                sums.x += x;
+                sums.y += y;
+                sums.xx += x * x;
+                sums.yy += y * y;
+                sums.xy += x * y;
+            }
+        }
+        out[k] = sums;
+    }
+}
+
+BitStats bit_stats(const uint64_t* a, const uint64_t* b, size_t words) {
+    BitStats stats;
+    for (size_t i = 0; i < words; ++i) {
+        stats.differing += __builtin_popcountll(a[i] ^ b[i]);
+        stats.common += __builtin_popcountll(a[i] & b[i]);
+    }
+    return stats;
+}
+
+void pack_bits(const uint8_t* bytes, size_t n, uint64_t* words) {
+    for (size_t w = 0; w * 64 < n; ++w) {
+        const size_t count = std::min<size_t>(64, n - w * 64);
+        uint64_t word = 0;
+        for (size_t i = 0; i < count; ++i) {
+            word |= static_cast<uint64_t>(bytes[w * 64 + i] >> 7) << i;
+        }
+        words[w] = word;
+    }
+}
+
+void moment_rows(const float* x, const float* y, size_t width, const float* taps, size_t count,
+                 float* mx, float* my, float* mxx, float* myy, float* mxy) {
+    for (size_t i = 0; i < width; ++i) {
+        float sx = 0.0f, sy = 0.0f, sxx = 0.0f, syy = 0.0f, sxy = 0.0f;
+        for (size_t k = 0; k < count; ++k) {
+            const float a = x[i + k], b = y[i + k], t = taps[k];
+            sx += t * a;
+            sy += t * b;
+            sxx += t * (a * a);
+            syy += t * (b * b);
+            sxy += t * (a * b);
+        }
+        mx[i] = sx;
+        my[i] = sy;
+        mxx[i] = sxx;
+        myy[i] = syy;
+        mxy[i] = sxy;
+    }
+}
+
+void filter_columns(const float* const* rows, const float* taps, size_t count, size_t width, float* out) {
+    for (size_t i = 0; i < width; ++i) {
+        float total = 0.0f;
+        for (size_t k = 0; k < count; ++k) {
+            total += taps[k] * rows[k][i];
+        }
+        out[i] = total;
+    }
+}
+
+void ssim_map(const float* mu1, const float* mu2, const float* exx, const float* eyy, const float* exy,
+              size_t n, float c1, float c2, float* ssim, float* cs) {
+    for (size_t i = 0; i < n; ++i) {
+        const float m11 = mu1[i] * mu1[i], m22 = mu2[i] * mu2[i], m12 = mu1[i] * mu2[i];
+        const float contrast = (2.0f * (exy[i] - m12) + c2) / ((exx[i] - m11) + (eyy[i] - m22) + c2);
+        const float luminance = (2.0f * m12 + c1) / (m11 + m22 + c1);
+        cs[i] = contrast;
+        ssim[i] = luminance * contrast;
+    }
+}
+
+void multiply4x4(const double* m, const double* in, double* out) {
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            double total = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                total += m[i * 4 + k] * in[k * 4 + j];
+            }
+            out[i * 4 + j] = total;
+        }
+    }
+}
+
+void transform8x8(const double* m, double* block) {
+    double temp[64];
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            double total = 0.0;
+            for (int k = 0; k < 8; ++k) {
+                total += block[i * 8 + k] * m[k * 8 + j];
+            }
+            temp[i * 8 + j] = total;
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            double total = 0.0;
+            for (int k = 0; k < 8; ++k) {
+                total += m[i * 8 + k] * temp[k * 8 + j];
+            }
+            block[i * 8 + j] = total;
+        }
+    }
+}
+
+void deinterleave_rgb(const uint8_t* rgb, size_t n, uint8_t* r, uint8_t* g, uint8_t* b) {
+    for (size_t i = 0; i < n; ++i) {
+        r[i] = rgb[3 * i];
+        g[i] = rgb[3 * i + 1];
+        b[i] = rgb[3 * i + 2];
+    }
+}
+
+void rgb_to_ycbcr(const uint8_t* rgb, double* ycbcr, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const double r = rgb[3 * i], g = rgb[3 * i + 1], b = rgb[3 * i + 2];
+        ycbcr[3 * i] = 0.299 * r + 0.587 * g + 0.114 * b;
+        ycbcr[3 * i + 1] = 128 + (-0.168736 * r - 0.331264 * g + 0.5 * b);
+        ycbcr[3 * i + 2] = 128 + (0.5 * r - 0.418688 * g - 0.081312 * b);
+    }
+}
+
+void ycbcr_to_rgb(const double* ycbcr, uint8_t* rgb, size_t n) {
+    auto to_byte = [](double v) {
+        return static_cast<uint8_t>(v < 0.0 ? 0.0 : (v > 255.0 ? 255.0 : v));
+    };
+    for (size_t i = 0; i < n; ++i) {
+        const double y = ycbcr[3 * i], cb = ycbcr[3 * i + 1], cr = ycbcr[3 * i + 2];
+        rgb[3 * i] = to_byte(y + 1.402 * (cr - 128));
+        rgb[3 * i + 1] = to_byte(y - 0.344136 * (cb - 128) - 0.714136 * (cr - 128));
+        rgb[3 * i + 2] = to_byte(y + 1.772 * (cb - 128));
+    }
+}
+
+void pob(uint8_t* pixels, uint8_t* key, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t low = pixels[2 * i + 1] & 0x0f;
+        key[i] = R_LUT[low];
+        pixels[2 * i + 1] = LOW_BITS_LUT[low];
+    }
+}
+
+void rev_pob(uint8_t* pixels, const uint8_t* key, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t k = key[i];
+        const uint8_t low = pixels[2 * i + 1];
+        pixels[2 * i + 1] = (k < 5 && low < 4) ? REV_LOW_BITS_LUT[k][low] : 0;
+    }
+}
+
+double sum(const double* x, size_t n) {
+    double lanes[SUM_LANES] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+        for (size_t l = 0; l < SUM_LANES; ++l) {
+            lanes[l] += x[i + l];
+        }
+    }
+    double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) {
+        total += x[i];
+    }
+    return total;
+}
+
+void teacher_step(const double* x, const double* r, const double* tf, double teacher, double mean,
+                  double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = x[i] + r[i] * (teacher - tf[i] * mean);
+    }
+}
+
+void learner_step(const double* x, const double* r, const double* direction, const int64_t* partner,
+                  double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = x[i] + r[i] * direction[i] * (x[i] - x[partner[i]]);
+    }
+}
+
+void clamp(double* x, double lower, double upper, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = x[i] < lower ? lower : (upper < x[i] ? upper : x[i]);
+    }
+}
+
+} // namespace simd::scalar
@@ -0,0 +1,338 @@
+// Проверка обещания из dispatch.hpp: варианты ядер всех наборов инструкций,
+// доступных на этой машине, дают побитово одинаковый результат.
+// Отдельная программа, в библиотеку не входит:
+//   g++ -std=c++20 -O2 -I. simd/test_kernels.cpp simd/dispatch.cpp simd/kernels_*.cpp -o test_kernels
+#include "dispatch.hpp"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+int failures = 0;
+std::mt19937 rng(1);
+
+void check(bool condition, const char* kernel, simd::Isa isa, size_t n) {
+    if (condition) return;
+    std::fprintf(stderr, "FAIL %s [%s] n=%zu\n", kernel, simd::isa_name(isa), n);
+    ++failures;
+}
+
+template <typename T>
+void append(Bytes& out, const T* data, size_t count) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(), p, p + count * sizeof(T));
+}
+
+template <typename T>
+void append(Bytes& out, const std::vector<T>& values) {
+    append(out, values.data(), values.size());
+}
+
+// fn() под каждой таблицей не выше обнаруженной; результат — байты всех выходов,
+// сравниваются со скалярными
+template <typename Fn>
+void for_each_isa(const char* kernel, size_t n, Fn fn) {
+    simd::set_isa(simd::Isa::SCALAR);
+    const Bytes expected = fn();
+    for (simd::Isa isa : {simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (!simd::set_isa(isa)) continue;
+        check(fn() == expected, kernel, isa, n);
+    }
+    simd::reset_isa();
+}
+
+Bytes random_bytes(size_t n) {
+    Bytes out(n);
+    for (uint8_t& v : out) v = static_cast<uint8_t>(rng());
+    return out;
+}
+
+std::vector<double> random_doubles(size_t n, double lower, double upper) {
+    std::uniform_real_distribution<double> dist(lower, upper);
+    std::vector<double> out(n);
+    for (double& v : out) v = dist(rng);
+    return out;
+}
+
+std::vector<float> random_floats(size_t n, float lower, float upper) {
+    std::uniform_real_distribution<float> dist(lower, upper);
+    std::vector<float> out(n);
+    for (float& v : out) v = dist(rng);
+    return out;
+}
+
+// Длины вокруг ширины регистра и больше FLUSH_ITERATIONS итераций AVX-512.
+// На последней при 0 против 255 32-битная ячейка без переноса в 64 бита
+// переполнилась бы и в AVX2, и в AVX-512
+const size_t LENGTHS[] = {0, 1, 31, 32, 33, 63, 64, 65, 4096 * 64 + 97, 5 * 4096 * 64 + 5};
+
+// Короткие длины для ядер над строками, блоками и столбцами популяции
+const size_t SHORT_LENGTHS[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100};
+
+void test_byte_kernels() {
+    for (size_t n : LENGTHS) {
+        const Bytes zeros(n, 0), full(n, 255), a = random_bytes(n), b = random_bytes(n);
+
+        // Наибольшая разность в каждом байте: точное значение известно заранее
+        simd::set_isa(simd::Isa::SCALAR);
+        check(simd::kernels().squared_error(zeros.data(), full.data(), n) == n * 255 * 255, "squared_error max",
+              simd::Isa::SCALAR, n);
+        for (const Bytes* x : {&zeros, &full, &a}) {
+            for (const Bytes* y : {&full, &b}) {
+                for_each_isa("squared_error", n, [&] {
+                    const uint64_t total = simd::kernels().squared_error(x->data(), y->data(), n);
+                    Bytes out;
+                    append(out, &total, 1);
+                    return out;
+                });
+                for_each_isa("byte_stats", n, [&] {
+                    const simd::ByteStats stats = simd::kernels().byte_stats(x->data(), y->data(), n);
+                    Bytes out;
+                    append(out, &stats, 1);
+                    return out;
+                });
+                for_each_isa("cross_stats", n, [&] {
+                    const simd::ByteStats stats = simd::kernels().cross_stats(x->data(), y->data(), n);
+                    Bytes out;
+                    append(out, &stats, 1);
+                    return out;
+                });
+            }
+        }
+    }
+}
+
+void test_bit_kernels() {
+    for (size_t n : SHORT_LENGTHS) {
+        const size_t bytes = n * 64 + n % 7;
+        const Bytes source = random_bytes(bytes);
+        for_each_isa("pack_bits", bytes, [&] {
+            std::vector<uint64_t> words((bytes + 63) / 64, ~uint64_t(0));
+            simd::kernels().pack_bits(source.data(), bytes, words.data());
+            Bytes out;
+            append(out, words);
+            return out;
+        });
+
+        std::vector<uint64_t> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = (uint64_t(rng()) << 32) | rng();
+            b[i] = (uint64_t(rng()) << 32) | rng();
+        }
+        for_each_isa("bit_stats", n, [&] {
+            const simd::BitStats stats = simd::kernels().bit_stats(a.data(), b.data(), n);
+            Bytes out;
+            append(out, &stats, 1);
+            return out;
+        });
+    }
+}
+
+void test_window_kernels() {
+    for (size_t count : SHORT_LENGTHS) {
+        const size_t stride = count * 8 + 3;
+        const Bytes zeros(stride * 8, 0), full(stride * 8, 255), a = random_bytes(stride * 8), b = random_bytes(stride * 8);
+        for (const Bytes* x : {&zeros, &a}) {
+            for (const Bytes* y : {&full, &b}) {
+                for_each_isa("window_sums", count, [&] {
+                    std::vector<simd::WindowSums> sums(count);
+                    simd::kernels().window_sums(x->data(), y->data(), stride, count, sums.data());
+                    Bytes out;
+                    append(out, sums);
+                    return out;
+                });
+                for_each_isa("block_sums", count, [&] {
+                    std::vector<simd::WindowSums> sums(count);
+                    simd::kernels().block_sums(x->data(), y->data(), stride, count, sums.data());
+                    Bytes out;
+                    append(out, sums);
+                    return out;
+                });
+            }
+        }
+    }
+}
+
+void test_gaussian_kernels() {
+    const float taps[11] = {0.001f, 0.0076f, 0.036f, 0.1095f, 0.2134f, 0.2648f,
+                            0.2134f, 0.1095f, 0.036f, 0.0076f, 0.001f};
+    for (size_t width : SHORT_LENGTHS) {
+        for (size_t count : {size_t(1), size_t(2), size_t(11)}) {
+            const std::vector<float> x = random_floats(width + count, 0.0f, 255.0f);
+            const std::vector<float> y = random_floats(width + count, 0.0f, 255.0f);
+            for_each_isa("moment_rows", width, [&] {
+                std::vector<float> m[5];
+                for (std::vector<float>& v : m) v.assign(width, -1.0f);
+                simd::kernels().moment_rows(x.data(), y.data(), width, taps, count, m[0].data(), m[1].data(),
+                                            m[2].data(), m[3].data(), m[4].data());
+                Bytes out;
+                for (const std::vector<float>& v : m) append(out, v);
+                return out;
+            });
+
+            std::vector<std::vector<float>> rows(count);
+            std::vector<const float*> pointers(count);
+            for (size_t k = 0; k < count; ++k) {
+                rows[k] = random_floats(width, 0.0f, 65025.0f);
+                pointers[k] = rows[k].data();
+            }
+            for_each_isa("filter_columns", width, [&] {
+                std::vector<float> filtered(width, -1.0f);
+                simd::kernels().filter_columns(pointers.data(), taps, count, width, filtered.data());
+                Bytes out;
+                append(out, filtered);
+                return out;
+            });
+        }
+
+        // Моменты согласованы: E[x²] ≥ μ², как после настоящей фильтрации
+        const std::vector<float> mu1 = random_floats(width, 0.0f, 255.0f), mu2 = random_floats(width, 0.0f, 255.0f);
+        const std::vector<float> var1 = random_floats(width, 0.0f, 500.0f), var2 = random_floats(width, 0.0f, 500.0f);
+        std::vector<float> exx(width), eyy(width), exy(width);
+        for (size_t i = 0; i < width; ++i) {
+            exx[i] = mu1[i] * mu1[i] + var1[i];
+            eyy[i] = mu2[i] * mu2[i] + var2[i];
+            exy[i] = mu1[i] * mu2[i] + 0.5f * (var1[i] - var2[i]);
+        }
+        for_each_isa("ssim_map", width, [&] {
+            std::vector<float> ssim(width, -1.0f), cs(width, -1.0f);
+            simd::kernels().ssim_map(mu1.data(), mu2.data(), exx.data(), eyy.data(), exy.data(), width, 6.5025f,
+                                     58.5225f, ssim.data(), cs.data());
+            Bytes out;
+            append(out, ssim);
+            append(out, cs);
+            return out;
+        });
+    }
+}
+
+void test_block_transforms() {
+    for (int trial = 0; trial < 16; ++trial) {
+        const std::vector<double> m4 = random_doubles(16, -1.0, 1.0), in4 = random_doubles(16, 0.0, 255.0);
+        for_each_isa("multiply4x4", 16, [&] {
+            double product[16];
+            simd::kernels().multiply4x4(m4.data(), in4.data(), product);
+            Bytes out;
+            append(out, product, 16);
+            return out;
+        });
+
+        const std::vector<double> m8 = random_doubles(64, -1.0, 1.0), block = random_doubles(64, -128.0, 127.0);
+        for_each_isa("transform8x8", 64, [&] {
+            std::vector<double> transformed = block;
+            simd::kernels().transform8x8(m8.data(), transformed.data());
+            Bytes out;
+            append(out, transformed);
+            return out;
+        });
+    }
+}
+
+void test_pixel_kernels() {
+    for (size_t n : SHORT_LENGTHS) {
+        const Bytes rgb = random_bytes(3 * n);
+        for_each_isa("deinterleave_rgb", n, [&] {
+            Bytes r(n), g(n), b(n);
+            simd::kernels().deinterleave_rgb(rgb.data(), n, r.data(), g.data(), b.data());
+            Bytes out = r;
+            append(out, g);
+            append(out, b);
+            return out;
+        });
+        for_each_isa("rgb_to_ycbcr", n, [&] {
+            std::vector<double> ycbcr(3 * n);
+            simd::kernels().rgb_to_ycbcr(rgb.data(), ycbcr.data(), n);
+            Bytes out;
+            append(out, ycbcr);
+            return out;
+        });
+
+        // С выходом за [0, 255], чтобы проверить насыщение
+        const std::vector<double> ycbcr = random_doubles(3 * n, -40.0, 300.0);
+        for_each_isa("ycbcr_to_rgb", n, [&] {
+            Bytes converted(3 * n);
+            simd::kernels().ycbcr_to_rgb(ycbcr.data(), converted.data(), n);
+            return converted;
+        });
+
+        const Bytes pixels = random_bytes(2 * n);
+        for_each_isa("pob", n, [&] {
+            Bytes transformed = pixels, key(n);
+            simd::kernels().pob(transformed.data(), key.data(), n);
+            append(transformed, key);
+            return transformed;
+        });
+        const Bytes key = random_bytes(n);
+        for_each_isa("rev_pob", n, [&] {
+            Bytes restored = pixels;
+            for (size_t i = 0; i < n; ++i) restored[2 * i + 1] &= 0x07;
+            simd::kernels().rev_pob(restored.data(), key.data(), n);
+            return restored;
+        });
+    }
+}
+
+void test_population_kernels() {
+    for (size_t n : SHORT_LENGTHS) {
+        const std::vector<double> x = random_doubles(n, -10.0, 10.0), r = random_doubles(n, 0.0, 1.0);
+        std::vector<double> tf(n), direction(n);
+        std::vector<int64_t> partner(n);
+        for (size_t i = 0; i < n; ++i) {
+            tf[i] = 1.0 + (rng() & 1);
+            direction[i] = (rng() & 1) ? 1.0 : -1.0;
+            partner[i] = static_cast<int64_t>(rng() % n);
+        }
+
+        for_each_isa("sum", n, [&] {
+            const double total = simd::kernels().sum(x.data(), n);
+            Bytes out;
+            append(out, &total, 1);
+            return out;
+        });
+        for_each_isa("teacher_step", n, [&] {
+            std::vector<double> stepped(n);
+            simd::kernels().teacher_step(x.data(), r.data(), tf.data(), 3.25, -0.75, stepped.data(), n);
+            Bytes out;
+            append(out, stepped);
+            return out;
+        });
+        for_each_isa("learner_step", n, [&] {
+            std::vector<double> stepped(n);
+            simd::kernels().learner_step(x.data(), r.data(), direction.data(), partner.data(), stepped.data(), n);
+            Bytes out;
+            append(out, stepped);
+            return out;
+        });
+        for_each_isa("clamp", n, [&] {
+            std::vector<double> clamped = x;
+            simd::kernels().clamp(clamped.data(), -2.5, 4.0, n);
+            Bytes out;
+            append(out, clamped);
+            return out;
+        });
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("detected: %s\n", simd::isa_name(simd::detected_isa()));
+    test_byte_kernels();
+    test_bit_kernels();
+    test_window_kernels();
+    test_gaussian_kernels();
+    test_block_transforms();
+    test_pixel_kernels();
+    test_population_kernels();
+
+    if (failures != 0) {
+        std::printf("%d failures\n", failures);
+        return 1;
+    }
+    std::printf("all kernels match\n");
+    return 0;
+}